@@ -90,24 +90,29 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleS
 
 	for(auto stack : stacks)
 	{
+		if(!stack->alive())
+			continue;
+
 		if(stack->unitSide() == side)
 			ourUnits.push_back(stack);
 		else
 			enemyUnits.push_back(stack);
 	}
 
-	for(auto ourUnit : ourUnits)
-	{
-		if(!ourUnit->alive())
-			continue;
+	auto ourDamage = hb->battleEstimateDamageMatrix(ourUnits, enemyUnits);
+	auto enemyDamage = hb->battleEstimateDamageMatrix(enemyUnits, ourUnits);
 
-		for(auto enemyUnit : enemyUnits)
+	for(size_t ourIndex = 0; ourIndex < ourUnits.size(); ourIndex++)
+	{
+		for(size_t enemyIndex = 0; enemyIndex < enemyUnits.size(); enemyIndex++)
 		{
-			if(enemyUnit->alive())
-			{
-				cacheDamage(ourUnit, enemyUnit, hb);
-				cacheDamage(enemyUnit, ourUnit, hb);
-			}
+			auto ourUnit = ourUnits[ourIndex];
+			auto enemyUnit = enemyUnits[enemyIndex];
+			auto ourUnitDamage = averageDmg(ourDamage[ourIndex * enemyUnits.size() + enemyIndex].damage);
+			auto enemyUnitDamage = averageDmg(enemyDamage[enemyIndex * ourUnits.size() + ourIndex].damage);
+
+			damageCache[ourUnit->unitId()][enemyUnit->unitId()] = static_cast<float>(ourUnitDamage) / ourUnit->getCount();
+			damageCache[enemyUnit->unitId()][ourUnit->unitId()] = static_cast<float>(enemyUnitDamage) / enemyUnit->getCount();
 		}
 	}
 }
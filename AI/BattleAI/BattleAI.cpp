@@ -41,6 +41,15 @@ CBattleAI::CBattleAI()
 
 CBattleAI::~CBattleAI()
 {
+	if(decisionStatistics.decisions)
+	{
+		logAi->debug("BattleAI made %d decisions, avg %d ms, max %d ms, %d ran out of time",
+			decisionStatistics.decisions,
+			decisionStatistics.totalTime / decisionStatistics.decisions,
+			decisionStatistics.maxTime,
+			decisionStatistics.outOfTime);
+	}
+
 	if(cb)
 	{
 		//Restore previous state of CB - it may be shared with the main AI (like VCAI)
@@ -128,6 +137,34 @@ int getSimulationTurnsCount(const StartInfo * startInfo)
 	return startInfo->difficulty < 4 ? 2 : 10;
 }
 
+int CBattleAI::getDecisionTimeBudget() const
+{
+	int budget = autobattlePreferences.decisionTimeLimit;
+	const auto & timers = env->game()->getStartInfo()->turnTimerInfo;
+
+	// leave half of unit timer as a reserve for simulation of the selected action and network latency
+	if(timers.unitTimer > 0)
+	{
+		int timerBudget = timers.unitTimer / 2;
+
+		budget = budget > 0 ? std::min(budget, timerBudget) : timerBudget;
+	}
+
+	return budget;
+}
+
+void CBattleAI::recordDecisionTime(uint64_t time, int budget, bool outOfTime)
+{
+	decisionStatistics.decisions++;
+	decisionStatistics.totalTime += time;
+	vstd::amax(decisionStatistics.maxTime, time);
+
+	if(outOfTime)
+		decisionStatistics.outOfTime++;
+
+	logAi->trace("BattleAI decision made in %lld, budget %d", time, budget);
+}
+
 void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 {
 	LOG_TRACE_PARAMS(logAi, "stack: %s", stack->nodeName());
@@ -142,6 +179,9 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 	BattleAction result = BattleAction::makeDefend(stack);
 
 	auto start = std::chrono::high_resolution_clock::now();
+	auto budget = getDecisionTimeBudget();
+	DecisionDeadline deadline(budget);
+	bool outOfTime = false;
 
 	try
 	{
@@ -165,6 +205,8 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 			getStrengthRatio(cb->getBattle(battleID), side),
 			getSimulationTurnsCount(env->game()->getStartInfo()));
 
+		evaluator.setDeadline(deadline);
+
 		result = evaluator.selectStackAction(stack);
 
 		if(autobattlePreferences.enableSpellsUsage && !skipCastUntilNextBattle && evaluator.canCastSpell())
@@ -172,11 +214,18 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 			auto spelCasted = evaluator.attemptCastingSpell(stack);
 
 			if(spelCasted)
+			{
+				recordDecisionTime(timeElapsed(start), budget, evaluator.isDeadlineReached());
 				return;
-			
-			skipCastUntilNextBattle = true;
+			}
+
+			// spells skipped because of time limit may still be useful later
+			if(!evaluator.isDeadlineReached())
+				skipCastUntilNextBattle = true;
 		}
 
+		outOfTime = evaluator.isDeadlineReached();
+		evaluator.logCacheStatistics();
 		logAi->trace("Spellcast attempt completed in %lld", timeElapsed(start));
 
 		if(auto action = considerFleeingOrSurrendering(battleID))
@@ -199,7 +248,7 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 		movesSkippedByDefense = 0;
 	}
 
-	logAi->trace("BattleAI decision made in %lld", timeElapsed(start));
+	recordDecisionTime(timeElapsed(start), budget, outOfTime);
 
 	cb->battleMakeUnitAction(battleID, result);
 }
@@ -52,6 +52,14 @@ struct CurrentOffensivePotential
 };
 */ // These lines may be useful but they are't used in the code.
 
+struct DecisionStatistics
+{
+	uint64_t decisions = 0;
+	uint64_t totalTime = 0; // ms
+	uint64_t maxTime = 0; // ms
+	uint64_t outOfTime = 0;
+};
+
 class CBattleAI : public CBattleGameInterface
 {
 	BattleSide side;
@@ -63,6 +71,10 @@ class CBattleAI : public CBattleGameInterface
 	bool wasUnlockingGs;
 	int movesSkippedByDefense;
 	bool skipCastUntilNextBattle;
+	DecisionStatistics decisionStatistics;
+
+	int getDecisionTimeBudget() const;
+	void recordDecisionTime(uint64_t time, int budget, bool outOfTime);
 
 public:
 	CBattleAI();
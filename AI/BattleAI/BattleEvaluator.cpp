@@ -87,6 +87,12 @@ BattleEvaluator::BattleEvaluator(
 	targets = std::make_unique<PotentialTargets>(activeStack, damageCache, hb);
 }
 
+void BattleEvaluator::setDeadline(const DecisionDeadline & newDeadline)
+{
+	deadline = newDeadline;
+	scoreEvaluator.setDeadline(newDeadline);
+}
+
 std::vector<BattleHex> BattleEvaluator::getBrokenWallMoatHexes() const
 {
 	std::vector<BattleHex> result;
@@ -644,6 +650,7 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 	}
 
 	CStopWatch timer;
+	std::atomic<size_t> skippedCasts = 0;
 
 #if BATTLE_TRACE_LEVEL >= 1
 	tbb::blocked_range<size_t> r(0, possibleCasts.size());
@@ -655,6 +662,14 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 			{
 				auto & ps = possibleCasts[i];
 
+				if(deadline.isReached())
+				{
+					// not evaluated casts never win over the attack selected already
+					ps.value = EvaluationResult::INEFFECTIVE_SCORE;
+					skippedCasts++;
+					continue;
+				}
+
 #if BATTLE_TRACE_LEVEL >= 1
 				if(ps.dest.empty())
 					logAi->trace("Evaluating %s", ps.spell->getNameTranslated());
@@ -699,6 +714,7 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 					PotentialTargets innerTargets(activeStack, innerCache, state);
 					BattleExchangeEvaluator innerEvaluator(state, env, strengthRatio, simulationTurnsCount);
 
+					innerEvaluator.setDeadline(deadline);
 					innerEvaluator.updateReachabilityMap(state);
 
 					auto moveTarget = innerEvaluator.findMoveTowardsUnreachable(activeStack, innerTargets, innerCache, state);
@@ -787,6 +803,9 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 
 	LOGFL("Evaluation took %d ms", timer.getDiff());
 
+	if(skippedCasts)
+		logAi->debug("Out of time, %d of %d spellcasts were not evaluated", skippedCasts.load(), possibleCasts.size());
+
 	auto castToPerform = *vstd::maxElementByFun(possibleCasts, [](const PossibleSpellcast & ps) -> float
 		{
 			return ps.value;
@@ -45,6 +45,7 @@ class BattleEvaluator
 	DamageCache damageCache;
 	float strengthRatio;
 	int simulationTurnsCount;
+	DecisionDeadline deadline;
 
 public:
 	BattleAction selectStackAction(const CStack * stack);
@@ -56,6 +57,9 @@ public:
 	void evaluateCreatureSpellcast(const CStack * stack, PossibleSpellcast & ps); //for offensive damaging spells only
 	void print(const std::string & text) const;
 	BattleAction moveOrAttack(const CStack * stack, BattleHex hex, const PotentialTargets & targets);
+	void logCacheStatistics() const { scoreEvaluator.logCacheStatistics(); }
+	void setDeadline(const DecisionDeadline & newDeadline);
+	bool isDeadlineReached() const { return deadline.isReached(); }
 
 	BattleEvaluator(
 		std::shared_ptr<Environment> env,
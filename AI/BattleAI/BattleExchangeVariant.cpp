@@ -217,7 +217,8 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 {
 	EvaluationResult result(targets.bestAction());
 
-	if(!activeStack->waited() && !activeStack->acquireState()->hadMorale)
+	// waited attack needs its own reachability map, do not build it if there is no time left to use it
+	if(!activeStack->waited() && !activeStack->acquireState()->hadMorale && !deadline.isReached())
 	{
 #if BATTLE_TRACE_LEVEL>=1
 		logAi->trace("Evaluating waited attack for %s", activeStack->getDescription());
@@ -231,6 +232,12 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 
 		for(auto & ap : targets.possibleAttacks)
 		{
+			if(deadline.isReached())
+			{
+				logAi->debug("Out of time, waited attacks evaluation is interrupted");
+				break;
+			}
+
 			float score = evaluateExchange(ap, 0, targets, damageCache, hbWaited);
 
 			if(score > result.score)
@@ -263,6 +270,13 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 
 	for(auto & ap : targets.possibleAttacks)
 	{
+		// keep at least one evaluated attack so result is never worse than simple heuristic
+		if(deadline.isReached() && result.score > EvaluationResult::INEFFECTIVE_SCORE)
+		{
+			logAi->debug("Out of time, best attack found so far is used");
+			break;
+		}
+
 		float score = evaluateExchange(ap, 0, targets, damageCache, hb);
 		bool sameScoreButWaited = vstd::isAlmostEqual(score, result.score) && result.wait;
 
@@ -358,6 +372,12 @@ MoveTarget BattleExchangeEvaluator::findMoveTowardsUnreachable(
 
 		for(auto & hex : hexes)
 		{
+			if(deadline.isReached() && !result.positions.empty())
+			{
+				logAi->debug("Out of time, best move found so far is used");
+				return result;
+			}
+
 			// FIXME: provide distance info for Jousting bonus
 			auto bai = BattleAttackInfo(activeStack, enemy, 0, cb->battleCanShoot(activeStack));
 			auto attack = AttackPossibility::evaluate(bai, hex, damageCache, hb);
@@ -585,6 +605,20 @@ float BattleExchangeEvaluator::evaluateExchange(
 	DamageCache & damageCache,
 	std::shared_ptr<HypotheticBattle> hb) const
 {
+	uint64_t key = BattleStateHash::combine(hb->getStateHash(), reachabilityStateHash);
+
+	key = BattleStateHash::combine(key, ap.attack.attacker->unitId());
+	key = BattleStateHash::combine(key, ap.attack.defender->unitId());
+	key = BattleStateHash::combine(key, ap.from.hex);
+	key = BattleStateHash::combine(key, ap.dest.hex);
+	key = BattleStateHash::combine(key, ap.attack.shooting);
+	key = BattleStateHash::combine(key, turn);
+
+	auto cached = exchangeTable.find(key);
+
+	if(cached)
+		return *cached;
+
 	BattleScore score = calculateExchange(ap, turn, targets, damageCache, hb);
 
 #if BATTLE_TRACE_LEVEL >= 1
@@ -596,7 +630,11 @@ float BattleExchangeEvaluator::evaluateExchange(
 		scoreValue(score));
 #endif
 
-	return scoreValue(score);
+	float result = scoreValue(score);
+
+	exchangeTable.store(key, result);
+
+	return result;
 }
 
 BattleScore BattleExchangeEvaluator::calculateExchange(
@@ -881,7 +919,12 @@ void BattleExchangeEvaluator::updateReachabilityMap(std::shared_ptr<HypotheticBa
 {
 	const int TURN_DEPTH = 2;
 
+	// map is already built for this state, f.e. by previous evaluation of same decision
+	if(!turnOrder.empty() && reachabilityStateHash == hb->getStateHash())
+		return;
+
 	turnOrder.clear();
+	reachabilityStateHash = hb->getStateHash();
 
 	hb->battleGetTurnOrder(turnOrder, std::numeric_limits<int>::max(), TURN_DEPTH);
 
@@ -929,7 +972,12 @@ std::vector<const battle::Unit *> BattleExchangeEvaluator::getOneTurnReachableUn
 			auto reachabilityIter = reachabilityCache.find(unit->unitId());
 			assert(reachabilityIter != reachabilityCache.end()); // missing updateReachabilityMap call?
 
-			ReachabilityInfo unitReachability = reachabilityIter != reachabilityCache.end() ? reachabilityIter->second : turnBattle.getReachability(unit);
+			std::shared_ptr<const ReachabilityInfo> missingReachability;
+
+			if(reachabilityIter == reachabilityCache.end())
+				missingReachability = getCachedReachability(turnBattle, unit);
+
+			const ReachabilityInfo & unitReachability = missingReachability ? *missingReachability : reachabilityIter->second;
 
 			bool reachable = unitReachability.distances.at(hex) <= radius;
 
@@ -958,6 +1006,33 @@ std::vector<const battle::Unit *> BattleExchangeEvaluator::getOneTurnReachableUn
 	return result;
 }
 
+std::shared_ptr<const ReachabilityInfo> BattleExchangeEvaluator::getCachedReachability(
+	HypotheticBattle & state,
+	const battle::Unit * unit) const
+{
+	uint64_t key = BattleStateHash::combine(state.getStateHash(), unit->unitId());
+	auto cached = reachabilityTable.find(key);
+
+	if(cached)
+		return *cached;
+
+	auto result = std::make_shared<const ReachabilityInfo>(state.getReachability(unit));
+
+	reachabilityTable.store(key, result);
+
+	return result;
+}
+
+void BattleExchangeEvaluator::logCacheStatistics() const
+{
+	logAi->trace(
+		"Exchange table: %d hits, %d misses. Reachability table: %d hits, %d misses",
+		exchangeTable.getHits(),
+		exchangeTable.getMisses(),
+		reachabilityTable.getHits(),
+		reachabilityTable.getMisses());
+}
+
 // avoid blocking path for stronger stack by weaker stack
 bool BattleExchangeEvaluator::checkPositionBlocksOurStacks(HypotheticBattle & hb, const battle::Unit * activeUnit, BattleHex position)
 {
@@ -985,7 +1060,8 @@ bool BattleExchangeEvaluator::checkPositionBlocksOurStacks(HypotheticBattle & hb
 			auto blockedUnitDamage = unit->getMinDamage(hb.battleCanShoot(unit)) * unit->getCount();
 			float ratio = blockedUnitDamage / (float)(blockedUnitDamage + activeUnitDamage + 0.01);
 
-			auto unitReachability = turnBattle.getReachability(unit);
+			auto cachedReachability = getCachedReachability(turnBattle, unit);
+			const ReachabilityInfo & unitReachability = *cachedReachability;
 			auto unitSpeed = unit->getMovementRange(turn); // Cached value, to avoid performance hit
 
 			for(BattleHex hex = BattleHex::TOP_LEFT; hex.isValid(); hex = hex + 1)
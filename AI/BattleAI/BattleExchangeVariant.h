@@ -13,6 +13,8 @@
 #include "../../lib/battle/ReachabilityInfo.h"
 #include "PotentialTargets.h"
 #include "StackWithBonuses.h"
+#include "TranspositionTable.h"
+#include "DecisionDeadline.h"
 
 struct BattleScore
 {
@@ -133,6 +135,15 @@ private:
 	std::vector<battle::Units> turnOrder;
 	float negativeEffectMultiplier;
 	int simulationTurnsCount;
+	DecisionDeadline deadline;
+
+	static constexpr size_t EXCHANGE_TABLE_SIZE = 4096;
+	static constexpr size_t REACHABILITY_TABLE_SIZE = 256;
+
+	// hash of the state reachability map and turn order were built for, exchange results depend on it
+	uint64_t reachabilityStateHash;
+	mutable TranspositionTable<float> exchangeTable;
+	mutable TranspositionTable<std::shared_ptr<const ReachabilityInfo>> reachabilityTable;
 
 	float scoreValue(const BattleScore & score) const;
 
@@ -151,7 +162,10 @@ public:
 		std::shared_ptr<CBattleInfoCallback> cb,
 		std::shared_ptr<Environment> env,
 		float strengthRatio,
-		int simulationTurnsCount): cb(cb), env(env), simulationTurnsCount(simulationTurnsCount){
+		int simulationTurnsCount)
+		: cb(cb), env(env), simulationTurnsCount(simulationTurnsCount), reachabilityStateHash(0),
+		exchangeTable(EXCHANGE_TABLE_SIZE), reachabilityTable(REACHABILITY_TABLE_SIZE)
+	{
 		negativeEffectMultiplier = strengthRatio >= 1 ? 1 : strengthRatio * strengthRatio;
 	}
 
@@ -188,6 +202,13 @@ public:
 
 	std::vector<const battle::Unit *> getAdjacentUnits(const battle::Unit * unit) const;
 
+	std::shared_ptr<const ReachabilityInfo> getCachedReachability(HypotheticBattle & state, const battle::Unit * unit) const;
+
+	void logCacheStatistics() const;
+
+	void setDeadline(const DecisionDeadline & newDeadline) { deadline = newDeadline; }
+	const DecisionDeadline & getDeadline() const { return deadline; }
+
 	float getPositiveEffectMultiplier() const { return 1; }
 	float getNegativeEffectMultiplier() const { return negativeEffectMultiplier; }
 };
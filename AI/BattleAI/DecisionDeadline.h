@@ -0,0 +1,41 @@
+/*
+ * DecisionDeadline.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+/// Point in time after which AI stops refining its decision and uses best action found so far.
+/// Default constructed deadline is never reached
+class DecisionDeadline
+{
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point deadline;
+
+public:
+	DecisionDeadline()
+		:deadline(Clock::time_point::max())
+	{
+	}
+
+	/// budget in milliseconds, zero or negative budget means no limit
+	explicit DecisionDeadline(int budget)
+		:deadline(budget > 0 ? Clock::now() + std::chrono::milliseconds(budget) : Clock::time_point::max())
+	{
+	}
+
+	bool isLimited() const
+	{
+		return deadline != Clock::time_point::max();
+	}
+
+	bool isReached() const
+	{
+		return isLimited() && Clock::now() >= deadline;
+	}
+};
@@ -9,10 +9,12 @@
  */
 #include "StdInc.h"
 #include "StackWithBonuses.h"
+#include "TranspositionTable.h"
 
 #include <vcmi/events/EventBus.h>
 
 #include "../../lib/CStack.h"
+#include "../../lib/battle/CObstacleInstance.h"
 #include "../../lib/ScriptHandler.h"
 #include "../../lib/networkPacks/PacksForClientBattle.h"
 #include "../../lib/networkPacks/SetStackEffect.h"
@@ -134,36 +136,45 @@ SlotID StackWithBonuses::unitSlot() const
 TConstBonusListPtr StackWithBonuses::getAllBonuses(const CSelector & selector, const CSelector & limit,
 	const std::string & cachingStr) const
 {
-	auto ret = std::make_shared<BonusList>();
 	TConstBonusListPtr originalList = origBearer->getAllBonuses(selector, limit, cachingStr);
 
-	vstd::copy_if(*originalList, std::back_inserter(*ret), [this](const std::shared_ptr<Bonus> & b)
-	{
-		return !vstd::contains(bonusesToRemove, b);
-	});
+	// unit without own changes sees exactly the same bonuses, no need to copy the list
+	if(bonusesToAdd.empty() && bonusesToUpdate.empty() && bonusesToRemove.empty())
+		return originalList;
+
+	auto ret = std::make_shared<BonusList>();
 
+	if(bonusesToRemove.empty())
+	{
+		*ret = *originalList;
+	}
+	else
+	{
+		vstd::copy_if(*originalList, std::back_inserter(*ret), [this](const std::shared_ptr<Bonus> & b)
+		{
+			return !vstd::contains(bonusesToRemove, b);
+		});
+	}
 
-	for(const Bonus & bonus : bonusesToUpdate)
+	for(const auto & bonus : bonusesToUpdate)
 	{
-		if(selector(&bonus) && (!limit || limit(&bonus)))
+		if(selector(bonus.get()) && (!limit || limit(bonus.get())))
 		{
-			if(ret->getFirst(Selector::source(BonusSource::SPELL_EFFECT, bonus.sid).And(Selector::typeSubtype(bonus.type, bonus.subtype))))
+			if(ret->getFirst(Selector::source(BonusSource::SPELL_EFFECT, bonus->sid).And(Selector::typeSubtype(bonus->type, bonus->subtype))))
 			{
-				actualizeEffect(ret, bonus);
+				actualizeEffect(ret, *bonus);
 			}
 			else
 			{
-				auto b = std::make_shared<Bonus>(bonus);
-				ret->push_back(b);
+				ret->push_back(bonus);
 			}
 		}
 	}
 
-	for(auto & bonus : bonusesToAdd)
+	for(const auto & bonus : bonusesToAdd)
 	{
-		auto b = std::make_shared<Bonus>(bonus);
-		if(selector(b.get()) && (!limit || !limit(b.get())))
-			ret->push_back(b);
+		if(selector(bonus.get()) && (!limit || !limit(bonus.get())))
+			ret->push_back(bonus);
 	}
 	//TODO limiters?
 	return ret;
@@ -181,7 +192,9 @@ int64_t StackWithBonuses::getTreeVersion() const
 
 void StackWithBonuses::addUnitBonus(const std::vector<Bonus> & bonus)
 {
-	vstd::concatenate(bonusesToAdd, bonus);
+	for(const auto & one : bonus)
+		bonusesToAdd.push_back(std::make_shared<Bonus>(one));
+
 	treeVersionLocal++;
 }
 
@@ -189,7 +202,9 @@ void StackWithBonuses::updateUnitBonus(const std::vector<Bonus> & bonus)
 {
 	//TODO: optimize, actualize to last value
 
-	vstd::concatenate(bonusesToUpdate, bonus);
+	for(const auto & one : bonus)
+		bonusesToUpdate.push_back(std::make_shared<Bonus>(one));
+
 	treeVersionLocal++;
 }
 
@@ -222,8 +237,8 @@ void StackWithBonuses::removeUnitBonus(const CSelector & selector)
 	for(auto b : *toRemove)
 		bonusesToRemove.insert(b);
 
-	vstd::erase_if(bonusesToAdd, [&](const Bonus & b){return selector(&b);});
-	vstd::erase_if(bonusesToUpdate, [&](const Bonus & b){return selector(&b);});
+	vstd::erase_if(bonusesToAdd, [&](const std::shared_ptr<Bonus> & b){return selector(b.get());});
+	vstd::erase_if(bonusesToUpdate, [&](const std::shared_ptr<Bonus> & b){return selector(b.get());});
 
 	treeVersionLocal++;
 }
@@ -286,8 +301,13 @@ std::shared_ptr<StackWithBonuses> HypotheticBattle::getForUpdate(uint32_t id)
 	if(iter == stackStates.end())
 	{
 		const battle::Unit * s = subject->battleGetUnitByID(id);
+		const auto * unitState = dynamic_cast<const battle::CUnitState *>(s);
+
+		// state of parent hypothetic battle can be copied directly without acquiring detached copy first
+		auto ret = unitState
+			? std::make_shared<StackWithBonuses>(this, unitState)
+			: std::make_shared<StackWithBonuses>(this, s);
 
-		auto ret = std::make_shared<StackWithBonuses>(this, s);
 		stackStates[id] = ret;
 		return ret;
 	}
@@ -311,7 +331,7 @@ battle::Units HypotheticBattle::getUnitsIf(const battle::UnitFilter & predicate)
 			ret.push_back(unit);
 	}
 
-	for(auto id_unit : stackStates)
+	for(const auto & id_unit : stackStates)
 	{
 		if(predicate(id_unit.second.get()))
 			ret.push_back(id_unit.second.get());
@@ -490,6 +510,66 @@ int64_t HypotheticBattle::getTreeVersion() const
 	return getBonusBearer()->getTreeVersion() + bonusTreeVersion;
 }
 
+uint64_t HypotheticBattle::getStateHash() const
+{
+	enum EFeature : uint64_t
+	{
+		POSITION, HEALTH, ALIVE, RETALIATION, SHOOTER, WAITED, DEFENDED, MOVED, BONUS_ADDED, BONUS_UPDATED, BONUS_REMOVED, OBSTACLE, WALL
+	};
+
+	uint64_t result = 0;
+
+	auto units = getUnitsIf([](const battle::Unit * u) -> bool { return true; });
+
+	for(const battle::Unit * unit : units)
+	{
+		uint64_t id = unit->unitId();
+
+		result ^= BattleStateHash::key(id, POSITION, unit->getPosition().hex);
+		result ^= BattleStateHash::key(id, HEALTH, unit->getAvailableHealth());
+		result ^= BattleStateHash::key(id, ALIVE, unit->alive());
+		result ^= BattleStateHash::key(id, RETALIATION, unit->ableToRetaliate());
+		result ^= BattleStateHash::key(id, SHOOTER, unit->canShoot());
+		result ^= BattleStateHash::key(id, WAITED, unit->waited());
+		result ^= BattleStateHash::key(id, DEFENDED, unit->defended());
+		result ^= BattleStateHash::key(id, MOVED, unit->moved());
+
+		auto state = stackStates.find(unit->unitId());
+
+		if(state == stackStates.end())
+			continue;
+
+		auto hashBonus = [](uint64_t hash, const Bonus & bonus) -> uint64_t
+		{
+			hash = BattleStateHash::combine(hash, static_cast<uint64_t>(bonus.type));
+			hash = BattleStateHash::combine(hash, bonus.subtype.getNum());
+			hash = BattleStateHash::combine(hash, static_cast<uint64_t>(bonus.source));
+			hash = BattleStateHash::combine(hash, bonus.sid.getNum());
+			hash = BattleStateHash::combine(hash, static_cast<uint64_t>(bonus.valType));
+			hash = BattleStateHash::combine(hash, bonus.val);
+
+			return BattleStateHash::combine(hash, bonus.turnsRemain);
+		};
+
+		for(const auto & bonus : state->second->bonusesToAdd)
+			result ^= BattleStateHash::key(id, BONUS_ADDED, hashBonus(0, *bonus));
+
+		for(const auto & bonus : state->second->bonusesToUpdate)
+			result ^= BattleStateHash::key(id, BONUS_UPDATED, hashBonus(0, *bonus));
+
+		for(const auto & bonus : state->second->bonusesToRemove)
+			result ^= BattleStateHash::key(id, BONUS_REMOVED, hashBonus(0, *bonus));
+	}
+
+	for(const auto & obstacle : battleGetAllObstacles())
+		result ^= BattleStateHash::key(obstacle->uniqueID, OBSTACLE, obstacle->pos.hex);
+
+	for(int part = 0; part < static_cast<int>(EWallPart::PARTS_COUNT); part++)
+		result ^= BattleStateHash::key(part, WALL, static_cast<int>(battleGetWallState(static_cast<EWallPart>(part))));
+
+	return result;
+}
+
 #if SCRIPTING_ENABLED
 Pool * HypotheticBattle::getContextPool() const
 {
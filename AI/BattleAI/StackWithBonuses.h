@@ -11,6 +11,8 @@
 
 #include <vstd/RNG.h>
 
+#include <boost/container/flat_map.hpp>
+
 #include <vcmi/Environment.h>
 #include <vcmi/ServerCallback.h>
 
@@ -64,8 +66,9 @@ public:
 class StackWithBonuses : public battle::CUnitState, public virtual IBonusBearer
 {
 public:
-	std::vector<Bonus> bonusesToAdd;
-	std::vector<Bonus> bonusesToUpdate;
+	// bonuses are immutable once added so states may share them instead of copying on every query
+	std::vector<std::shared_ptr<Bonus>> bonusesToAdd;
+	std::vector<std::shared_ptr<Bonus>> bonusesToUpdate;
 	std::set<std::shared_ptr<Bonus>> bonusesToRemove;
 	int treeVersionLocal;
 
@@ -119,7 +122,7 @@ private:
 class HypotheticBattle : public BattleProxy, public battle::IUnitEnvironment
 {
 public:
-	std::map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
+	boost::container::flat_map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
 
 	const Environment * env;
 
@@ -164,6 +167,10 @@ public:
 
 	int64_t getTreeVersion() const;
 
+	/// Hash of unit positions, health, flags and bonus changes. Equal states produce equal hashes
+	/// regardless of the way they were reached, so it can be used to index evaluated states
+	uint64_t getStateHash() const;
+
 	void makeWait(const battle::Unit * activeStack);
 
 	void resetActiveUnit()
@@ -0,0 +1,91 @@
+/*
+ * TranspositionTable.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+namespace BattleStateHash
+{
+	/// Mixes feature of a unit into pseudo-random 64-bit key. Keys of all features are xor-ed together
+	/// so result does not depend on order of units, like classic zobrist hashing without precomputed tables
+	inline uint64_t key(uint64_t owner, uint64_t feature, uint64_t value)
+	{
+		uint64_t x = (owner << 48) ^ (feature << 40) ^ value;
+
+		// splitmix64 finalizer
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+		return x ^ (x >> 31);
+	}
+
+	inline uint64_t combine(uint64_t hash, uint64_t value)
+	{
+		return hash ^ (key(0, 0, value) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+	}
+}
+
+/// Fixed size table of evaluations indexed by hash of battle state.
+/// Colliding entries are simply replaced so memory usage stays bounded.
+template<typename TValue>
+class TranspositionTable
+{
+private:
+	std::vector<std::optional<std::pair<uint64_t, TValue>>> entries;
+	mutable std::mutex sync;
+	mutable std::atomic<uint64_t> hits;
+	mutable std::atomic<uint64_t> misses;
+
+public:
+	/// capacity is rounded up to power of two
+	explicit TranspositionTable(size_t capacity)
+		:hits(0), misses(0)
+	{
+		size_t size = 1;
+
+		while(size < capacity)
+			size <<= 1;
+
+		entries.resize(size);
+	}
+
+	std::optional<TValue> find(uint64_t key) const
+	{
+		std::lock_guard<std::mutex> lock(sync);
+
+		auto & entry = entries[key & (entries.size() - 1)];
+
+		if(entry && entry->first == key)
+		{
+			hits.fetch_add(1, std::memory_order_relaxed);
+			return entry->second;
+		}
+
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+
+	void store(uint64_t key, const TValue & value)
+	{
+		std::lock_guard<std::mutex> lock(sync);
+
+		entries[key & (entries.size() - 1)] = std::make_pair(key, value);
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(sync);
+
+		for(auto & entry : entries)
+			entry.reset();
+	}
+
+	uint64_t getHits() const { return hits.load(std::memory_order_relaxed); }
+	uint64_t getMisses() const { return misses.load(std::memory_order_relaxed); }
+};
@@ -22,6 +22,7 @@ std::map<ObjectInstanceID, std::unique_ptr<GraphPaths>>  AIPathfinder::heroGraph
 AIPathfinder::AIPathfinder(CPlayerSpecificInfoCallback * cb, Nullkiller * ai)
 	:cb(cb), ai(ai)
 {
+	chainCache = std::make_unique<HeroChainCache>(ai);
 }
 
 void AIPathfinder::init()
@@ -96,6 +97,7 @@ void AIPathfinder::updatePaths(const std::map<const CGHeroInstance *, HeroRole>
 
 	if(pathfinderSettings.useHeroChain)
 	{
+		chainCache->updateHeroes(heroes);
 		storage->setTownsAndDwellings(cb->getTownsInfo(), ai->memory->visitableObjs);
 	}
 
@@ -141,6 +143,7 @@ void AIPathfinder::updatePaths(const std::map<const CGHeroInstance *, HeroRole>
 		}
 	} while(storage->increaseHeroChainTurnLimit());
 
+	chainCache->logStatistics();
 	logAi->trace("Recalculated paths in %ld", timeElapsed(start));
 }
 
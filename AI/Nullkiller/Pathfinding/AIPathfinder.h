@@ -13,6 +13,7 @@
 #include "AINodeStorage.h"
 #include "ObjectGraph.h"
 #include "GraphPaths.h"
+#include "HeroChainCache.h"
 #include "../AIUtility.h"
 
 namespace NKAI
@@ -39,6 +40,7 @@ class AIPathfinder
 {
 private:
 	std::shared_ptr<AINodeStorage> storage;
+	std::unique_ptr<HeroChainCache> chainCache;
 	CPlayerSpecificInfoCallback * cb;
 	Nullkiller * ai;
 	static std::map<ObjectInstanceID, std::unique_ptr<GraphPaths>>  heroGraphs;
@@ -57,6 +59,11 @@ public:
 		return storage;
 	}
 
+	HeroChainCache * getChainCache()
+	{
+		return chainCache.get();
+	}
+
 	std::vector<AIPath> getPathInfo(const int3 & tile, bool includeGraph = false)
 	{
 		std::vector<AIPath> result;
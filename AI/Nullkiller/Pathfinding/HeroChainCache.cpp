@@ -0,0 +1,134 @@
+/*
+* HeroChainCache.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "HeroChainCache.h"
+#include "../Engine/Nullkiller.h"
+#include "../../../lib/mapObjects/CGHeroInstance.h"
+
+namespace NKAI
+{
+
+HeroChainCache::HeroChainCache(const Nullkiller * ai)
+	:ai(ai), hits(0), misses(0)
+{
+}
+
+HeroChainCache::TArmyContent HeroChainCache::getArmyContent(const CCreatureSet * army)
+{
+	TArmyContent result;
+
+	result.reserve(army->Slots().size());
+
+	for(auto & slot : army->Slots())
+		result.emplace_back(slot.first.getNum(), slot.second->getCreatureID().getNum(), slot.second->count);
+
+	return result;
+}
+
+HeroChainCache::THeroSignature HeroChainCache::getHeroSignature(const CGHeroInstance * hero) const
+{
+	std::vector<std::pair<int, int>> morale;
+
+	// same filter as ArmyManager::getBestArmy uses for morale of the resulting army
+	auto bonusModifiers = hero->getBonuses(Selector::type()(BonusType::MORALE));
+
+	for(auto bonus : *bonusModifiers)
+	{
+		if(bonus->source != BonusSource::ARMY && bonus->source != BonusSource::OBJECT_INSTANCE && bonus->source != BonusSource::OBJECT_TYPE)
+		{
+			morale.emplace_back(bonus->val, static_cast<int>(bonus->valType));
+		}
+	}
+
+	return THeroSignature(getArmyContent(hero), hero->level, std::move(morale));
+}
+
+void HeroChainCache::updateHeroes(const std::map<const CGHeroInstance *, HeroRole> & activeHeroes)
+{
+	boost::unique_lock lock(sync);
+
+	std::map<ObjectInstanceID, HeroExchanges> updated;
+
+	for(auto & hero : activeHeroes)
+	{
+		auto & entry = updated[hero.first->id];
+		auto previous = heroes.find(hero.first->id);
+
+		entry.signature = getHeroSignature(hero.first);
+
+		if(previous != heroes.end() && previous->second.signature == entry.signature)
+		{
+			entry.exchanges = std::move(previous->second.exchanges);
+		}
+#if NKAI_TRACE_LEVEL >= 1
+		else
+		{
+			logAi->trace("Hero chain cache of %s is invalidated", hero.first->getNameTranslated());
+		}
+#endif
+	}
+
+	heroes = std::move(updated);
+}
+
+std::vector<SlotInfo> HeroChainCache::getBestArmy(const CGHeroInstance * hero, const CCreatureSet * army1, const CCreatureSet * army2)
+{
+	TExchangeKey key(getArmyContent(army1), getArmyContent(army2), army2->needsLastStack());
+
+	{
+		boost::shared_lock lock(sync);
+
+		auto heroEntry = heroes.find(hero->id);
+
+		if(heroEntry == heroes.end())
+		{
+			lock.unlock();
+			misses++;
+
+			return ai->armyManager->getBestArmy(hero, army1, army2);
+		}
+
+		auto cached = heroEntry->second.exchanges.find(key);
+
+		if(cached != heroEntry->second.exchanges.end())
+		{
+			hits++;
+
+			return cached->second;
+		}
+	}
+
+	misses++;
+
+	auto result = ai->armyManager->getBestArmy(hero, army1, army2);
+
+	boost::unique_lock lock(sync);
+
+	auto heroEntry = heroes.find(hero->id);
+
+	if(heroEntry != heroes.end())
+	{
+		auto & exchanges = heroEntry->second.exchanges;
+
+		if(exchanges.size() >= MAX_EXCHANGES_PER_HERO)
+			exchanges.clear();
+
+		exchanges[key] = result;
+	}
+
+	return result;
+}
+
+void HeroChainCache::logStatistics() const
+{
+	logAi->trace("Hero chain cache: %d hits, %d misses", hits.load(), misses.load());
+}
+
+}
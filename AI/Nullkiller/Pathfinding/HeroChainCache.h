@@ -0,0 +1,63 @@
+/*
+* HeroChainCache.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+
+#pragma once
+
+#include "../AIUtility.h"
+#include "../Analyzers/ArmyManager.h"
+
+namespace NKAI
+{
+
+class Nullkiller;
+
+/// Keeps results of army exchanges calculated for hero chains between passes and turns.
+/// Entries of a hero are dropped as soon as anything affecting the exchange changes (army, level, morale bonuses).
+/// Cache is created together with pathfinder, so it never outlives the game it was filled in.
+class HeroChainCache
+{
+private:
+	/// Slot, creature and count of every stack in army
+	using TArmyContent = std::vector<std::tuple<int32_t, int32_t, TQuantity>>;
+	using TExchangeKey = std::tuple<TArmyContent, TArmyContent, bool>;
+
+	/// Army, level and morale bonuses (value and value type) of hero
+	using THeroSignature = std::tuple<TArmyContent, int, std::vector<std::pair<int, int>>>;
+
+	struct HeroExchanges
+	{
+		THeroSignature signature;
+		std::map<TExchangeKey, std::vector<SlotInfo>> exchanges;
+	};
+
+	static constexpr size_t MAX_EXCHANGES_PER_HERO = 4096;
+
+	const Nullkiller * ai;
+	std::map<ObjectInstanceID, HeroExchanges> heroes;
+	boost::shared_mutex sync;
+	std::atomic<uint64_t> hits;
+	std::atomic<uint64_t> misses;
+
+public:
+	HeroChainCache(const Nullkiller * ai);
+
+	/// Invalidates exchanges of heroes which were changed or lost since previous update
+	void updateHeroes(const std::map<const CGHeroInstance *, HeroRole> & activeHeroes);
+
+	std::vector<SlotInfo> getBestArmy(const CGHeroInstance * hero, const CCreatureSet * army1, const CCreatureSet * army2);
+
+	void logStatistics() const;
+
+private:
+	static TArmyContent getArmyContent(const CCreatureSet * army);
+	THeroSignature getHeroSignature(const CGHeroInstance * hero) const;
+};
+
+}
@@ -638,6 +638,7 @@ void CPlayerInterface::battleStart(const BattleID & battleID, const CCreatureSet
 
 		AutocombatPreferences autocombatPreferences = AutocombatPreferences();
 		autocombatPreferences.enableSpellsUsage = settings["battle"]["enableAutocombatSpells"].Bool();
+		autocombatPreferences.decisionTimeLimit = settings["battle"]["autocombatDecisionTimeLimit"].Integer();
 
 		autofightingAI->initBattleInterface(env, cb, autocombatPreferences);
 		autofightingAI->battleStart(battleID, army1, army2, tile, hero1, hero2, side, false);
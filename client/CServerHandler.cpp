@@ -915,6 +915,23 @@ void CServerHandler::visitForLobby(CPackForLobby & lobbyPack)
 
 void CServerHandler::visitForClient(CPackForClient & clientPack)
 {
+	if(auto * batch = dynamic_cast<PackBatch *>(&clientPack))
+	{
+		// packs from single server action, apply them one by one in same order as server did
+		size_t offset = 0;
+		for(uint32_t packSize : batch->packSizes)
+		{
+			CPack * pack = logicConnection->retrievePack(batch->packsData.data() + offset, packSize);
+			offset += packSize;
+
+			ServerHandlerCPackVisitor visitor(*this);
+			pack->visit(visitor);
+		}
+
+		delete batch;
+		return;
+	}
+
 	client->handlePack(&clientPack);
 }
 
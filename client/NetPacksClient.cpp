@@ -174,6 +174,9 @@ void ApplyClientNetPackVisitor::visitSetMovePoints(SetMovePoints & pack)
 
 void ApplyClientNetPackVisitor::visitFoWChange(FoWChange & pack)
 {
+	// set of tiles is only needed by interfaces of allied players, build it once if any of them is present
+	std::optional<std::unordered_set<int3>> tiles;
+
 	for(auto &i : cl.playerint)
 	{
 		if(cl.getPlayerRelations(i.first, pack.player) == PlayerRelations::SAME_PLAYER && pack.waitForDialogs && LOCPLINT == i.second.get())
@@ -182,10 +185,13 @@ void ApplyClientNetPackVisitor::visitFoWChange(FoWChange & pack)
 		}
 		if(cl.getPlayerRelations(i.first, pack.player) != PlayerRelations::ENEMIES)
 		{
+			if(!tiles)
+				tiles = pack.getTiles();
+
 			if(pack.mode == ETileVisibility::REVEALED)
-				i.second->tileRevealed(pack.tiles);
+				i.second->tileRevealed(*tiles);
 			else
-				i.second->tileHidden(pack.tiles);
+				i.second->tileHidden(*tiles);
 		}
 	}
 	cl.invalidatePaths();
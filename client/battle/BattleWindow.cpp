@@ -700,6 +700,7 @@ void BattleWindow::bAutofightf()
 
 		AutocombatPreferences autocombatPreferences = AutocombatPreferences();
 		autocombatPreferences.enableSpellsUsage = settings["battle"]["enableAutocombatSpells"].Bool();
+		autocombatPreferences.decisionTimeLimit = settings["battle"]["autocombatDecisionTimeLimit"].Integer();
 
 		ai->initBattleInterface(owner.curInt->env, owner.curInt->cb, autocombatPreferences);
 		ai->battleStart(owner.getBattleID(), owner.army1, owner.army2, int3(0,0,0), owner.attackingHeroInstance, owner.defendingHeroInstance, owner.getBattle()->battleGetMySide(), false);
@@ -901,6 +902,7 @@ void BattleWindow::endWithAutocombat()
 
 			AutocombatPreferences autocombatPreferences = AutocombatPreferences();
 			autocombatPreferences.enableSpellsUsage = settings["battle"]["enableAutocombatSpells"].Bool();
+			autocombatPreferences.decisionTimeLimit = settings["battle"]["autocombatDecisionTimeLimit"].Integer();
 
 			ai->initBattleInterface(owner.curInt->env, owner.curInt->cb, autocombatPreferences);
 			ai->battleStart(owner.getBattleID(), owner.army1, owner.army2, int3(0,0,0), owner.attackingHeroInstance, owner.defendingHeroInstance, owner.getBattle()->battleGetMySide(), false);
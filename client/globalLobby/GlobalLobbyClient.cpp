@@ -66,6 +66,12 @@ void GlobalLobbyClient::onPacketReceived(const std::shared_ptr<INetworkConnectio
 	if(json["type"].String() == "activeGameRooms")
 		return receiveActiveGameRooms(json);
 
+	if(json["type"].String() == "activeAccountsUpdate")
+		return receiveActiveAccountsUpdate(json);
+
+	if(json["type"].String() == "activeGameRoomsUpdate")
+		return receiveActiveGameRoomsUpdate(json);
+
 	if(json["type"].String() == "joinRoomSuccess")
 		return receiveJoinRoomSuccess(json);
 
@@ -111,6 +117,15 @@ void GlobalLobbyClient::receiveClientLoginSuccess(const JsonNode & json)
 	setAccountDisplayName(json["displayName"].String());
 	setAccountCookie(json["accountCookie"].String());
 
+	// older lobby does not know about incremental updates and would reject requests for them
+	// full lists are sent by lobby on login, so only updates need to be enabled
+	if (json["incrementalUpdates"].Bool())
+	{
+		JsonNode toSend;
+		toSend["type"].String() = "enableIncrementalUpdates";
+		sendMessage(toSend);
+	}
+
 	auto loginWindowPtr = loginWindow.lock();
 
 	if(!loginWindowPtr || !GH.windows().topWindow<GlobalLobbyLoginWindow>())
@@ -176,21 +191,93 @@ void GlobalLobbyClient::receiveChatMessage(const JsonNode & json)
 	}
 }
 
+static GlobalLobbyAccount loadActiveAccount(const JsonNode & jsonEntry)
+{
+	GlobalLobbyAccount account;
+
+	account.accountID = jsonEntry["accountID"].String();
+	account.displayName = jsonEntry["displayName"].String();
+	account.status = jsonEntry["status"].String();
+
+	return account;
+}
+
+static GlobalLobbyRoom loadActiveGameRoom(const JsonNode & jsonEntry)
+{
+	GlobalLobbyRoom room;
+
+	room.gameRoomID = jsonEntry["gameRoomID"].String();
+	room.hostAccountID = jsonEntry["hostAccountID"].String();
+	room.hostAccountDisplayName = jsonEntry["hostAccountDisplayName"].String();
+	room.description = jsonEntry["description"].String();
+	room.statusID = jsonEntry["status"].String();
+	room.gameVersion = jsonEntry["version"].String();
+	room.modList = ModVerificationInfo::jsonDeserializeList(jsonEntry["mods"]);
+	std::chrono::seconds ageSeconds (jsonEntry["ageSeconds"].Integer());
+	room.startDateFormatted = TextOperations::getCurrentFormattedDateTimeLocal(-ageSeconds);
+
+	for(const auto & jsonParticipant : jsonEntry["participants"].Vector())
+	{
+		GlobalLobbyAccount account;
+		account.accountID =  jsonParticipant["accountID"].String();
+		account.displayName =  jsonParticipant["displayName"].String();
+		room.participants.push_back(account);
+	}
+
+	for(const auto & jsonParticipant : jsonEntry["invited"].Vector())
+	{
+		GlobalLobbyAccount account;
+		account.accountID =  jsonParticipant["accountID"].String();
+		account.displayName =  jsonParticipant["displayName"].String();
+		room.invited.push_back(account);
+	}
+
+	room.playerLimit = jsonEntry["playerLimit"].Integer();
+
+	return room;
+}
+
 void GlobalLobbyClient::receiveActiveAccounts(const JsonNode & json)
 {
 	activeAccounts.clear();
+	activeAccountsVersion = json["version"].Integer();
+	activeAccountsRequested = false;
 
 	for(const auto & jsonEntry : json["accounts"].Vector())
+		activeAccounts.push_back(loadActiveAccount(jsonEntry));
+
+	onActiveAccountsChanged();
+}
+
+void GlobalLobbyClient::receiveActiveAccountsUpdate(const JsonNode & json)
+{
+	if (json["version"].Integer() != activeAccountsVersion + 1)
 	{
-		GlobalLobbyAccount account;
+		logGlobal->warn("Lobby account list update is out of order, requesting full lists");
+		return requestActiveLists();
+	}
+
+	activeAccountsVersion = json["version"].Integer();
 
-		account.accountID = jsonEntry["accountID"].String();
-		account.displayName = jsonEntry["displayName"].String();
-		account.status = jsonEntry["status"].String();
+	for(const auto & removedID : json["removed"].Vector())
+		vstd::erase_if(activeAccounts, [&removedID](const GlobalLobbyAccount & account){ return account.accountID == removedID.String(); });
 
-		activeAccounts.push_back(account);
+	for(const auto & jsonEntry : json["changed"].Vector())
+	{
+		auto account = loadActiveAccount(jsonEntry);
+		auto existing = boost::find_if(activeAccounts, [&account](const GlobalLobbyAccount & entry){ return entry.accountID == account.accountID; });
+
+		if (existing != activeAccounts.end())
+			*existing = account;
+		else
+			activeAccounts.push_back(account);
 	}
 
+	onActiveAccountsChanged();
+}
+
+void GlobalLobbyClient::onActiveAccountsChanged()
+{
 	auto lobbyWindowPtr = lobbyWindow.lock();
 	if(lobbyWindowPtr)
 		lobbyWindowPtr->onActiveAccounts(activeAccounts);
@@ -202,42 +289,44 @@ void GlobalLobbyClient::receiveActiveAccounts(const JsonNode & json)
 void GlobalLobbyClient::receiveActiveGameRooms(const JsonNode & json)
 {
 	activeRooms.clear();
+	activeRoomsVersion = json["version"].Integer();
+	activeRoomsRequested = false;
 
 	for(const auto & jsonEntry : json["gameRooms"].Vector())
-	{
-		GlobalLobbyRoom room;
+		activeRooms.push_back(loadActiveGameRoom(jsonEntry));
 
-		room.gameRoomID = jsonEntry["gameRoomID"].String();
-		room.hostAccountID = jsonEntry["hostAccountID"].String();
-		room.hostAccountDisplayName = jsonEntry["hostAccountDisplayName"].String();
-		room.description = jsonEntry["description"].String();
-		room.statusID = jsonEntry["status"].String();
-		room.gameVersion = jsonEntry["version"].String();
-		room.modList = ModVerificationInfo::jsonDeserializeList(jsonEntry["mods"]);
-		std::chrono::seconds ageSeconds (jsonEntry["ageSeconds"].Integer());
-		room.startDateFormatted = TextOperations::getCurrentFormattedDateTimeLocal(-ageSeconds);
+	onActiveGameRoomsChanged();
+}
 
-		for(const auto & jsonParticipant : jsonEntry["participants"].Vector())
-		{
-			GlobalLobbyAccount account;
-			account.accountID =  jsonParticipant["accountID"].String();
-			account.displayName =  jsonParticipant["displayName"].String();
-			room.participants.push_back(account);
-		}
+void GlobalLobbyClient::receiveActiveGameRoomsUpdate(const JsonNode & json)
+{
+	if (json["version"].Integer() != activeRoomsVersion + 1)
+	{
+		logGlobal->warn("Lobby game room list update is out of order, requesting full lists");
+		return requestActiveLists();
+	}
 
-		for(const auto & jsonParticipant : jsonEntry["invited"].Vector())
-		{
-			GlobalLobbyAccount account;
-			account.accountID =  jsonParticipant["accountID"].String();
-			account.displayName =  jsonParticipant["displayName"].String();
-			room.invited.push_back(account);
-		}
+	activeRoomsVersion = json["version"].Integer();
 
-		room.playerLimit = jsonEntry["playerLimit"].Integer();
+	for(const auto & removedID : json["removed"].Vector())
+		vstd::erase_if(activeRooms, [&removedID](const GlobalLobbyRoom & room){ return room.gameRoomID == removedID.String(); });
 
-		activeRooms.push_back(room);
+	for(const auto & jsonEntry : json["changed"].Vector())
+	{
+		auto room = loadActiveGameRoom(jsonEntry);
+		auto existing = boost::find_if(activeRooms, [&room](const GlobalLobbyRoom & entry){ return entry.gameRoomID == room.gameRoomID; });
+
+		if (existing != activeRooms.end())
+			*existing = room;
+		else
+			activeRooms.insert(activeRooms.begin(), room); // new rooms are the most recent ones
 	}
 
+	onActiveGameRoomsChanged();
+}
+
+void GlobalLobbyClient::onActiveGameRoomsChanged()
+{
 	auto lobbyWindowPtr = lobbyWindow.lock();
 	if(lobbyWindowPtr)
 		lobbyWindowPtr->onActiveGameRooms(activeRooms);
@@ -246,6 +335,20 @@ void GlobalLobbyClient::receiveActiveGameRooms(const JsonNode & json)
 		window->onActiveGameRooms(activeRooms);
 }
 
+void GlobalLobbyClient::requestActiveLists()
+{
+	// full lists will be sent by lobby, ignore any updates until both are received
+	if (activeAccountsRequested || activeRoomsRequested)
+		return;
+
+	activeAccountsRequested = true;
+	activeRoomsRequested = true;
+
+	JsonNode toSend;
+	toSend["type"].String() = "requestActiveLists";
+	sendMessage(toSend);
+}
+
 void GlobalLobbyClient::receiveMatchesHistory(const JsonNode & json)
 {
 	matchesHistory.clear();
@@ -27,6 +27,13 @@ class GlobalLobbyClient final : public INetworkClientListener, boost::noncopyabl
 	std::set<std::string> activeInvites;
 	std::vector<GlobalLobbyRoom> matchesHistory;
 
+	/// versions of account and room lists, used to detect missed incremental updates
+	int64_t activeAccountsVersion = 0;
+	int64_t activeRoomsVersion = 0;
+	/// full lists that were requested from lobby but not received yet
+	bool activeAccountsRequested = false;
+	bool activeRoomsRequested = false;
+
 	/// Contains known history of each channel
 	/// Key: concatenated channel type and channel name
 	/// Value: list of known chat messages
@@ -52,10 +59,16 @@ class GlobalLobbyClient final : public INetworkClientListener, boost::noncopyabl
 	void receiveChatMessage(const JsonNode & json);
 	void receiveActiveAccounts(const JsonNode & json);
 	void receiveActiveGameRooms(const JsonNode & json);
+	void receiveActiveAccountsUpdate(const JsonNode & json);
+	void receiveActiveGameRoomsUpdate(const JsonNode & json);
 	void receiveMatchesHistory(const JsonNode & json);
 	void receiveJoinRoomSuccess(const JsonNode & json);
 	void receiveInviteReceived(const JsonNode & json);
 
+	void onActiveAccountsChanged();
+	void onActiveGameRoomsChanged();
+	void requestActiveLists();
+
 	std::shared_ptr<GlobalLobbyLoginWindow> createLoginWindow();
 	std::shared_ptr<GlobalLobbyWindow> createLobbyWindow();
 
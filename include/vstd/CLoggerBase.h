@@ -64,9 +64,16 @@ public:
 	virtual bool isDebugEnabled() const = 0;
 	virtual bool isTraceEnabled() const = 0;
 
+	/// Returns true if a log message of specified level will be logged
+	virtual bool isEnabled(ELogLevel::ELogLevel level) const = 0;
+
 	template<typename T, typename ... Args>
 	void log(ELogLevel::ELogLevel level, const std::string & format, T t, Args ... args) const
 	{
+		// formatting is expensive, skip it for messages that won't be logged anyway
+		if(!isEnabled(level))
+			return;
+
 		try
 		{
 			boost::format fmt(format);
@@ -12,6 +12,7 @@
 struct AutocombatPreferences
 {
 	bool enableSpellsUsage = true;
+	int decisionTimeLimit = 0; //in ms, time AI may spend on a single unit action, 0 - no limit
 	//TODO: below options exist in original H3, consider usefulness of mixed human-AI combat when enabling autocombat inside battle
 //	bool enableUnitsUsage = true;
 //	bool enableCatapultUsage = true;
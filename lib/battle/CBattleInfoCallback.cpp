@@ -771,6 +771,43 @@ DamageEstimation CBattleInfoCallback::battleEstimateDamage(const battle::Unit *
 	return battleEstimateDamage(bai, retaliationDmg);
 }
 
+std::vector<DamageEstimation> CBattleInfoCallback::battleEstimateDamageMatrix(const battle::Units & attackers, const battle::Units & defenders) const
+{
+	RETURN_IF_NOT_BATTLE({});
+
+	std::vector<DamageEstimation> result;
+	result.reserve(attackers.size() * defenders.size());
+
+	// factors depend on type of attack, so unit may need both melee and ranged variant
+	std::vector<std::array<std::optional<DamageCalculator::AttackerFactors>, 2>> attackerFactors(attackers.size());
+	std::vector<std::array<std::optional<DamageCalculator::DefenderFactors>, 2>> defenderFactors(defenders.size());
+
+	for(size_t attackerIndex = 0; attackerIndex < attackers.size(); attackerIndex++)
+	{
+		for(size_t defenderIndex = 0; defenderIndex < defenders.size(); defenderIndex++)
+		{
+			const auto * attacker = attackers[attackerIndex];
+			const auto * defender = defenders[defenderIndex];
+			const bool shooting = battleCanShoot(attacker, defender->getPosition());
+			const BattleAttackInfo bai(attacker, defender, 0, shooting);
+			const DamageCalculator calculator(*this, bai);
+
+			auto & attackerCache = attackerFactors[attackerIndex][shooting];
+			auto & defenderCache = defenderFactors[defenderIndex][shooting];
+
+			if(!attackerCache)
+				attackerCache = calculator.getAttackerFactors();
+
+			if(!defenderCache)
+				defenderCache = calculator.getDefenderFactors();
+
+			result.push_back(calculator.calculateDmgRange(*attackerCache, *defenderCache));
+		}
+	}
+
+	return result;
+}
+
 DamageEstimation CBattleInfoCallback::battleEstimateDamage(const BattleAttackInfo & bai, DamageEstimation * retaliationDmg) const
 {
 	RETURN_IF_NOT_BATTLE({});
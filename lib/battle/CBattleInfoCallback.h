@@ -104,6 +104,11 @@ public:
 	DamageEstimation battleEstimateDamage(const battle::Unit * attacker, const battle::Unit * defender, BattleHex attackerPosition, DamageEstimation * retaliationDmg = nullptr) const;
 	DamageEstimation battleEstimateDamage(const battle::Unit * attacker, const battle::Unit * defender, int getMovementRange, DamageEstimation * retaliationDmg = nullptr) const;
 
+	/// estimates damage of every attacker against every defender without movement and retaliation
+	/// bonuses of each unit are queried once for whole batch instead of once per pair
+	/// result is indexed as [attackerIndex * defenders.size() + defenderIndex]
+	std::vector<DamageEstimation> battleEstimateDamageMatrix(const battle::Units & attackers, const battle::Units & defenders) const;
+
 	bool battleIsInsideWalls(BattleHex from) const;
 	bool battleHasPenaltyOnLine(BattleHex from, BattleHex dest, bool checkWall, bool checkMoat) const;
 	bool battleHasDistancePenalty(const IBonusBearer * shooter, BattleHex shooterPosition, BattleHex destHex) const;
@@ -134,20 +134,13 @@ int DamageCalculator::getActorAttackBase() const
 	return info.attacker->getAttack(info.shooting);
 }
 
-int DamageCalculator::getActorAttackEffective() const
+int DamageCalculator::getActorAttackIgnored(int attackBase, int multAttackReductionPercent) const
 {
-	return getActorAttackBase() + getActorAttackSlayer() + getActorAttackIgnored();
-}
-
-int DamageCalculator::getActorAttackIgnored() const
-{
-	int multAttackReductionPercent = battleBonusValue(info.defender, Selector::type()(BonusType::ENEMY_ATTACK_REDUCTION));
-
 	if(multAttackReductionPercent > 0)
 	{
 		//using ints so 1.5 for 5 attack is rounded down as in HotA / h3assist etc. (keep in mind h3assist 1.2 shows wrong value for 15 attack points and unupg. nix)
-		int reduction = vstd::divideAndRound( getActorAttackBase() * multAttackReductionPercent, 100);
-		return -std::min(reduction, getActorAttackBase());
+		int reduction = vstd::divideAndRound( attackBase * multAttackReductionPercent, 100);
+		return -std::min(reduction, attackBase);
 	}
 	return 0;
 }
@@ -189,27 +182,20 @@ int DamageCalculator::getTargetDefenseBase() const
 	return info.defender->getDefense(info.shooting);
 }
 
-int DamageCalculator::getTargetDefenseEffective() const
+int DamageCalculator::getTargetDefenseIgnored(int defenseBase, int multDefenceReductionPercent) const
 {
-	return getTargetDefenseBase() + getTargetDefenseIgnored();
-}
-
-int DamageCalculator::getTargetDefenseIgnored() const
-{
-	double multDefenceReduction = battleBonusValue(info.attacker, Selector::type()(BonusType::ENEMY_DEFENCE_REDUCTION)) / 100.0;
+	double multDefenceReduction = multDefenceReductionPercent / 100.0;
 
 	if(multDefenceReduction > 0)
 	{
-		int reduction = std::floor(multDefenceReduction * getTargetDefenseBase()) + 1;
-		return -std::min(reduction,getTargetDefenseBase());
+		int reduction = std::floor(multDefenceReduction * defenseBase) + 1;
+		return -std::min(reduction, defenseBase);
 	}
 	return 0;
 }
 
-double DamageCalculator::getAttackSkillFactor() const
+double DamageCalculator::getAttackSkillFactor(int attackAdvantage) const
 {
-	int attackAdvantage = getActorAttackEffective() - getTargetDefenseEffective();
-
 	if(attackAdvantage > 0)
 	{
 		const double attackMultiplier = VLC->settings()->getDouble(EGameSettings::COMBAT_ATTACK_POINT_DAMAGE_FACTOR);
@@ -305,10 +291,8 @@ double DamageCalculator::getAttackRevengeFactor() const
 	return 0.0;
 }
 
-double DamageCalculator::getDefenseSkillFactor() const
+double DamageCalculator::getDefenseSkillFactor(int defenseAdvantage) const
 {
-	int defenseAdvantage = getTargetDefenseEffective() - getActorAttackEffective();
-
 	//bonus from attack/defense skills
 	if(defenseAdvantage > 0) //decreasing dmg
 	{
@@ -462,36 +446,33 @@ double DamageCalculator::getDefenseMindFactor() const
 	return 0.0;
 }
 
-std::vector<double> DamageCalculator::getAttackFactors() const
+DamageCalculator::AttackerFactors DamageCalculator::getAttackerFactors() const
 {
-	return {
-		getAttackSkillFactor(),
-		getAttackOffenseArcheryFactor(),
-		getAttackBlessFactor(),
-		getAttackLuckFactor(),
-		getAttackJoustingFactor(),
-		getAttackDeathBlowFactor(),
-		getAttackDoubleDamageFactor(),
-		getAttackHateFactor(),
-		getAttackRevengeFactor()
-	};
+	AttackerFactors result;
+
+	result.baseDamage = getBaseDamageStack();
+	result.attackBase = getActorAttackBase();
+	result.enemyDefenceReduction = battleBonusValue(info.attacker, Selector::type()(BonusType::ENEMY_DEFENCE_REDUCTION));
+	result.offenseArcheryFactor = getAttackOffenseArcheryFactor();
+	result.blessFactor = getAttackBlessFactor();
+	result.revengeFactor = getAttackRevengeFactor();
+	result.blindParalysisFactor = getDefenseBlindParalysisFactor();
+	result.forgetfulnessFactor = getDefenseForgetfulnessFactor();
+
+	return result;
 }
 
-std::vector<double> DamageCalculator::getDefenseFactors() const
+DamageCalculator::DefenderFactors DamageCalculator::getDefenderFactors() const
 {
-	return {
-		getDefenseSkillFactor(),
-		getDefenseArmorerFactor(),
-		getDefenseMagicShieldFactor(),
-		getDefenseRangePenaltiesFactor(),
-		getDefenseObstacleFactor(),
-		getDefenseBlindParalysisFactor(),
-		getDefenseUnluckyFactor(),
-		getDefenseForgetfulnessFactor(),
-		getDefensePetrificationFactor(),
-		getDefenseMagicFactor(),
-		getDefenseMindFactor()
-	};
+	DefenderFactors result;
+
+	result.defenseBase = getTargetDefenseBase();
+	result.enemyAttackReduction = battleBonusValue(info.defender, Selector::type()(BonusType::ENEMY_ATTACK_REDUCTION));
+	result.armorerFactor = getDefenseArmorerFactor();
+	result.magicShieldFactor = getDefenseMagicShieldFactor();
+	result.petrificationFactor = getDefensePetrificationFactor();
+
+	return result;
 }
 
 DamageRange DamageCalculator::getCasualties(const DamageRange & damageDealt) const
@@ -526,10 +507,41 @@ int DamageCalculator::battleBonusValue(const IBonusBearer * bearer, const CSelec
 
 DamageEstimation DamageCalculator::calculateDmgRange() const
 {
-	DamageRange damageBase = getBaseDamageStack();
+	return calculateDmgRange(getAttackerFactors(), getDefenderFactors());
+}
+
+DamageEstimation DamageCalculator::calculateDmgRange(const AttackerFactors & attacker, const DefenderFactors & defender) const
+{
+	const DamageRange & damageBase = attacker.baseDamage;
+
+	int attackEffective = attacker.attackBase + getActorAttackSlayer() + getActorAttackIgnored(attacker.attackBase, defender.enemyAttackReduction);
+	int defenseEffective = defender.defenseBase + getTargetDefenseIgnored(defender.defenseBase, attacker.enemyDefenceReduction);
+
+	const std::array<double, 9> attackFactors = {
+		getAttackSkillFactor(attackEffective - defenseEffective),
+		attacker.offenseArcheryFactor,
+		attacker.blessFactor,
+		getAttackLuckFactor(),
+		getAttackJoustingFactor(),
+		getAttackDeathBlowFactor(),
+		getAttackDoubleDamageFactor(),
+		getAttackHateFactor(),
+		attacker.revengeFactor
+	};
 
-	auto attackFactors = getAttackFactors();
-	auto defenseFactors = getDefenseFactors();
+	const std::array<double, 11> defenseFactors = {
+		getDefenseSkillFactor(defenseEffective - attackEffective),
+		defender.armorerFactor,
+		defender.magicShieldFactor,
+		getDefenseRangePenaltiesFactor(),
+		getDefenseObstacleFactor(),
+		attacker.blindParalysisFactor,
+		getDefenseUnluckyFactor(),
+		attacker.forgetfulnessFactor,
+		defender.petrificationFactor,
+		getDefenseMagicFactor(),
+		getDefenseMindFactor()
+	};
 
 	double attackFactorTotal = 1.0;
 	double defenseFactorTotal = 1.0;
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "../GameConstants.h"
+#include "IBattleInfoCallback.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -18,11 +19,34 @@ class CBattleInfoCallback;
 class IBonusBearer;
 class CSelector;
 struct BattleAttackInfo;
-struct DamageRange;
-struct DamageEstimation;
 
 class DLL_LINKAGE DamageCalculator
 {
+public:
+	/// Values that depend only on attacking unit and type of attack
+	struct AttackerFactors
+	{
+		DamageRange baseDamage;
+		int attackBase = 0;
+		int enemyDefenceReduction = 0;
+		double offenseArcheryFactor = 0;
+		double blessFactor = 0;
+		double revengeFactor = 0;
+		double blindParalysisFactor = 0;
+		double forgetfulnessFactor = 0;
+	};
+
+	/// Values that depend only on defending unit and type of attack
+	struct DefenderFactors
+	{
+		int defenseBase = 0;
+		int enemyAttackReduction = 0;
+		double armorerFactor = 0;
+		double magicShieldFactor = 0;
+		double petrificationFactor = 0;
+	};
+
+private:
 	const CBattleInfoCallback & callback;
 	const BattleAttackInfo & info;
 
@@ -36,14 +60,12 @@ class DLL_LINKAGE DamageCalculator
 	DamageRange getBaseDamageStack() const;
 
 	int getActorAttackBase() const;
-	int getActorAttackEffective() const;
 	int getActorAttackSlayer() const;
-	int getActorAttackIgnored() const;
+	int getActorAttackIgnored(int attackBase, int reductionPercent) const;
 	int getTargetDefenseBase() const;
-	int getTargetDefenseEffective() const;
-	int getTargetDefenseIgnored() const;
+	int getTargetDefenseIgnored(int defenseBase, int reductionPercent) const;
 
-	double getAttackSkillFactor() const;
+	double getAttackSkillFactor(int attackAdvantage) const;
 	double getAttackOffenseArcheryFactor() const;
 	double getAttackBlessFactor() const;
 	double getAttackLuckFactor() const;
@@ -53,7 +75,7 @@ class DLL_LINKAGE DamageCalculator
 	double getAttackHateFactor() const;
 	double getAttackRevengeFactor() const;
 
-	double getDefenseSkillFactor() const;
+	double getDefenseSkillFactor(int defenseAdvantage) const;
 	double getDefenseArmorerFactor() const;
 	double getDefenseMagicShieldFactor() const;
 	double getDefenseRangePenaltiesFactor() const;
@@ -65,15 +87,19 @@ class DLL_LINKAGE DamageCalculator
 	double getDefenseMagicFactor() const;
 	double getDefenseMindFactor() const;
 
-	std::vector<double> getAttackFactors() const;
-	std::vector<double> getDefenseFactors() const;
 public:
 	DamageCalculator(const CBattleInfoCallback & callback, const BattleAttackInfo & info ):
 		callback(callback),
 		info(info)
 	{}
 
+	AttackerFactors getAttackerFactors() const;
+	DefenderFactors getDefenderFactors() const;
+
 	DamageEstimation calculateDmgRange() const;
+
+	/// Same as calculateDmgRange() but reuses factors queried before, e.g. for other pair of units with the same attacker
+	DamageEstimation calculateDmgRange(const AttackerFactors & attacker, const DefenderFactors & defender) const;
 };
 
 VCMI_LIB_NAMESPACE_END
@@ -57,6 +57,9 @@ std::unordered_set<ResourcePath> CMappedFileLoader::getFilteredFiles(std::functi
 }
 
 CFilesystemList::CFilesystemList()
+	: indexRevision(0)
+	, contentRevision(1)
+	, parent(nullptr)
 {
 }
 
@@ -64,12 +67,82 @@ CFilesystemList::~CFilesystemList()
 {
 }
 
+void CFilesystemList::rebuildIndex() const
+{
+	index.clear();
+
+	for(const auto & loader : loaders)
+		for(const auto & entry : loader->getFilteredFiles([](const ResourcePath &){ return true; }))
+			index[entry].push_back(loader.get());
+}
+
+void CFilesystemList::invalidateIndex() const
+{
+	for(const CFilesystemList * list = this; list != nullptr; list = list->parent)
+		list->contentRevision++;
+}
+
+void CFilesystemList::addToIndex(const ResourcePath & resourceName, const ISimpleResourceLoader * owner) const
+{
+	{
+		boost::unique_lock<boost::shared_mutex> lock(indexMutex);
+
+		// outdated index will be rebuilt on next access anyway
+		if(indexRevision == contentRevision)
+		{
+			auto & owners = index[resourceName];
+			if(!vstd::contains(owners, owner))
+			{
+				// keep loaders in mount order
+				TLoadersList updated;
+				for(const auto & loader : loaders)
+					if(loader.get() == owner || vstd::contains(owners, loader.get()))
+						updated.push_back(loader.get());
+				owners = std::move(updated);
+			}
+		}
+	}
+
+	if(parent)
+		parent->addToIndex(resourceName, this);
+}
+
+void CFilesystemList::findLoaders(const ResourcePath & resourceName, const std::function<void(const TLoadersList *)> & callback) const
+{
+	{
+		boost::shared_lock<boost::shared_mutex> lock(indexMutex);
+		if(indexRevision == contentRevision)
+		{
+			auto it = index.find(resourceName);
+			callback(it == index.end() ? nullptr : &it->second);
+			return;
+		}
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(indexMutex);
+	uint32_t revision = contentRevision;
+	if(indexRevision != revision)
+	{
+		rebuildIndex();
+		indexRevision = revision;
+	}
+
+	auto it = index.find(resourceName);
+	callback(it == index.end() ? nullptr : &it->second);
+}
+
 std::unique_ptr<CInputStream> CFilesystemList::load(const ResourcePath & resourceName) const
 {
 	// load resource from last loader that have it (last overridden version)
-	for(const auto & loader : boost::adaptors::reverse(loaders))
-		if (loader->existsResource(resourceName))
-			return loader->load(resourceName);
+	const ISimpleResourceLoader * owner = nullptr;
+	findLoaders(resourceName, [&owner](const TLoadersList * found)
+	{
+		if(found)
+			owner = found->back();
+	});
+
+	if(owner)
+		return owner->load(resourceName);
 
 	throw std::runtime_error("Resource with name " + resourceName.getName() + " and type "
 		+ EResTypeHelper::getEResTypeAsString(resourceName.getType()) + " wasn't found.");
@@ -77,10 +150,12 @@ std::unique_ptr<CInputStream> CFilesystemList::load(const ResourcePath & resourc
 
 bool CFilesystemList::existsResource(const ResourcePath & resourceName) const
 {
-	for(const auto & loader : loaders)
-		if (loader->existsResource(resourceName))
-			return true;
-	return false;
+	bool result = false;
+	findLoaders(resourceName, [&result](const TLoadersList * found)
+	{
+		result = found != nullptr;
+	});
+	return result;
 }
 
 std::string CFilesystemList::getMountPoint() const
@@ -113,6 +188,8 @@ void CFilesystemList::updateFilteredFiles(std::function<bool(const std::string &
 {
 	for(const auto & loader : loaders)
 		loader->updateFilteredFiles(filter);
+
+	invalidateIndex();
 }
 
 std::unordered_set<ResourcePath> CFilesystemList::getFilteredFiles(std::function<bool(const ResourcePath &)> filter) const
@@ -134,6 +211,9 @@ bool CFilesystemList::createResource(const std::string & filename, bool update)
 		if (writeableLoaders.count(loader.get()) != 0                       // writeable,
 			&& loader->createResource(filename, update))          // successfully created
 		{
+			// saves are created often, so new entry is added to existing index instead of rebuilding it
+			addToIndex(ResourcePath(filename), loader.get());
+
 			// Check if resource was created successfully. Possible reasons for this to fail
 			// a) loader failed to create resource (e.g. read-only FS)
 			// b) in update mode, call with filename that does not exists
@@ -149,9 +229,16 @@ bool CFilesystemList::createResource(const std::string & filename, bool update)
 
 std::vector<const ISimpleResourceLoader *> CFilesystemList::getResourcesWithName(const ResourcePath & resourceName) const
 {
-	std::vector<const ISimpleResourceLoader *> ret;
+	TLoadersList owners;
+	findLoaders(resourceName, [&owners](const TLoadersList * found)
+	{
+		if(found)
+			owners = *found;
+	});
 
-	for(const auto & loader : loaders)
+	// loaders may be lists that have several versions of this resource
+	std::vector<const ISimpleResourceLoader *> ret;
+	for(const auto & loader : owners)
 		boost::range::copy(loader->getResourcesWithName(resourceName), std::back_inserter(ret));
 
 	return ret;
@@ -162,6 +249,12 @@ void CFilesystemList::addLoader(ISimpleResourceLoader * loader, bool writeable)
 	loaders.push_back(std::unique_ptr<ISimpleResourceLoader>(loader));
 	if (writeable)
 		writeableLoaders.insert(loader);
+
+	auto * list = dynamic_cast<CFilesystemList *>(loader);
+	if (list)
+		list->parent = this;
+
+	invalidateIndex();
 }
 
 bool CFilesystemList::removeLoader(ISimpleResourceLoader * loader)
@@ -172,6 +265,7 @@ bool CFilesystemList::removeLoader(ISimpleResourceLoader * loader)
 		{
 			loaders.erase(loaderIterator);
 			writeableLoaders.erase(loader);
+			invalidateIndex();
 			return true;
 		}
 	}
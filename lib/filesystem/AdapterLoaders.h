@@ -55,10 +55,34 @@ private:
 
 class DLL_LINKAGE CFilesystemList : public ISimpleResourceLoader
 {
+	using TLoadersList = std::vector<const ISimpleResourceLoader *>;
+
 	std::vector<std::unique_ptr<ISimpleResourceLoader> > loaders;
 
 	std::set<ISimpleResourceLoader *> writeableLoaders;
 
+	/// Merged index of content of all loaders: resource -> loaders that have it, in mount order
+	/// Rebuilt on first access after change in this list or in any of nested lists
+	mutable std::unordered_map<ResourcePath, TLoadersList> index;
+	mutable uint32_t indexRevision;
+	mutable boost::shared_mutex indexMutex;
+
+	/// Increased on every change of content of this list or of any of nested lists
+	mutable std::atomic<uint32_t> contentRevision;
+
+	/// List that owns this list as one of its loaders, if any
+	const CFilesystemList * parent;
+
+	/// Calls callback with loaders that have such resource, or with nullptr if there are none
+	void findLoaders(const ResourcePath & resourceName, const std::function<void(const TLoadersList *)> & callback) const;
+	void rebuildIndex() const;
+
+	/// Marks index of this list and of all its parents as outdated
+	void invalidateIndex() const;
+
+	/// Adds newly created resource to index of this list and of all its parents without full rebuild
+	void addToIndex(const ResourcePath & resourceName, const ISimpleResourceLoader * owner) const;
+
 	//FIXME: this is only compile fix, should be removed in the end
 	CFilesystemList(CFilesystemList &) = delete;
 	CFilesystemList &operator=(CFilesystemList &) = delete;
@@ -14,13 +14,57 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-CZipStream::CZipStream(const std::shared_ptr<CIOApi> & api, const boost::filesystem::path & archive, unz64_file_pos filepos)
+CZipHandlePool::CZipHandlePool(const std::shared_ptr<CIOApi> & api, const boost::filesystem::path & archive):
+	ioApi(api),
+	zlibApi(api->getApiStructure()),
+	archiveName(archive)
 {
-	zlib_filefunc64_def zlibApi;
+}
+
+CZipHandlePool::~CZipHandlePool()
+{
+	for(auto & handle : freeHandles)
+		unzClose(handle);
+}
+
+unzFile CZipHandlePool::acquire()
+{
+	{
+		std::lock_guard<std::mutex> lock(mx);
+		if(!freeHandles.empty())
+		{
+			unzFile handle = freeHandles.back();
+			freeHandles.pop_back();
+			return handle;
+		}
+	}
 
-	zlibApi = api->getApiStructure();
+	unzFile handle = unzOpen2_64(archiveName.c_str(), &zlibApi);
+	if(handle == nullptr)
+		throw std::runtime_error("Failed to open zip archive " + archiveName.string());
+	return handle;
+}
+
+void CZipHandlePool::release(unzFile handle)
+{
+	// keep enough handles for all loading threads, close the rest
+	const size_t maxFreeHandles = std::max(4u, boost::thread::hardware_concurrency());
+
+	std::unique_lock<std::mutex> lock(mx);
+	if(freeHandles.size() < maxFreeHandles)
+	{
+		freeHandles.push_back(handle);
+		return;
+	}
+	lock.unlock();
+
+	unzClose(handle);
+}
 
-	file = unzOpen2_64(archive.c_str(), &zlibApi);
+CZipStream::CZipStream(const std::shared_ptr<CZipHandlePool> & pool, unz64_file_pos filepos):
+	pool(pool),
+	file(pool->acquire())
+{
 	unzGoToFilePos64(file, &filepos);
 	unzOpenCurrentFile(file);
 }
@@ -28,7 +72,7 @@ CZipStream::CZipStream(const std::shared_ptr<CIOApi> & api, const boost::filesys
 CZipStream::~CZipStream()
 {
 	unzCloseCurrentFile(file);
-	unzClose(file);
+	pool->release(file);
 }
 
 si64 CZipStream::readMore(ui8 * data, si64 size)
@@ -56,6 +100,7 @@ CZipLoader::CZipLoader(const std::string & mountPoint, const boost::filesystem::
 	zlibApi(ioApi->getApiStructure()),
 	archiveName(archive),
 	mountPoint(mountPoint),
+	handles(std::make_shared<CZipHandlePool>(ioApi, archive)),
 	files(listFiles(mountPoint, archive))
 {
 	logGlobal->trace("Zip archive loaded, %d files found", files.size());
@@ -88,14 +133,17 @@ std::unordered_map<ResourcePath, unz64_file_pos> CZipLoader::listFiles(const std
 		}
 		while (unzGoToNextFile(file) == UNZ_OK);
 	}
-	unzClose(file);
+
+	// directory of archive is already parsed, keep this handle for loading of files
+	if(file != nullptr)
+		handles->release(file);
 
 	return ret;
 }
 
 std::unique_ptr<CInputStream> CZipLoader::load(const ResourcePath & resourceName) const
 {
-	return std::unique_ptr<CInputStream>(new CZipStream(ioApi, archiveName, files.at(resourceName)));
+	return std::make_unique<CZipStream>(handles, files.at(resourceName));
 }
 
 bool CZipLoader::existsResource(const ResourcePath & resourceName) const
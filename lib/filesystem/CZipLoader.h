@@ -18,18 +18,39 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Thread-safe set of opened handles to the same archive.
+/// Opening an archive requires parsing of its central directory, so handles are reused between streams
+class DLL_LINKAGE CZipHandlePool : boost::noncopyable
+{
+	std::shared_ptr<CIOApi> ioApi;
+	zlib_filefunc64_def zlibApi;
+	boost::filesystem::path archiveName;
+
+	std::mutex mx;
+	std::vector<unzFile> freeHandles;
+
+public:
+	CZipHandlePool(const std::shared_ptr<CIOApi> & api, const boost::filesystem::path & archive);
+	~CZipHandlePool();
+
+	/// Returns free handle to archive, opening new one if there are none
+	unzFile acquire();
+	/// Returns handle to pool. Handle must not have opened file
+	void release(unzFile handle);
+};
+
 class DLL_LINKAGE CZipStream : public CBufferedStream
 {
+	std::shared_ptr<CZipHandlePool> pool;
 	unzFile file;
 
 public:
 	/**
 	 * @brief constructs zip stream from already opened file
-	 * @param api virtual filesystem interface
-	 * @param archive path to archive to open
+	 * @param pool pool of handles to archive
 	 * @param filepos position of file to open
 	 */
-	CZipStream(const std::shared_ptr<CIOApi> & api, const boost::filesystem::path & archive, unz64_file_pos filepos);
+	CZipStream(const std::shared_ptr<CZipHandlePool> & pool, unz64_file_pos filepos);
 	~CZipStream();
 
 	si64 getSize() override;
@@ -45,6 +66,7 @@ class DLL_LINKAGE CZipLoader : public ISimpleResourceLoader
 	zlib_filefunc64_def zlibApi;
 	boost::filesystem::path archiveName;
 	std::string mountPoint;
+	std::shared_ptr<CZipHandlePool> handles;
 
 	std::unordered_map<ResourcePath, unz64_file_pos> files;
 
@@ -48,21 +48,38 @@ static inline std::string readName(std::string name, bool uppercase)
 	return name;
 }
 
+const std::string * ResourcePath::intern(const std::string & name)
+{
+	// nodes of unordered_set are never relocated, so pointers to elements remain valid
+	static std::unordered_set<std::string> names;
+	static boost::shared_mutex namesMutex;
+
+	{
+		boost::shared_lock<boost::shared_mutex> lock(namesMutex);
+		auto it = names.find(name);
+		if (it != names.end())
+			return &*it;
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(namesMutex);
+	return &*names.insert(name).first;
+}
+
 ResourcePath::ResourcePath(const std::string & name_):
 	type(readType(name_)),
-	name(readName(name_, true)),
+	name(intern(readName(name_, true))),
 	originalName(readName(name_, false))
 {}
 
 ResourcePath::ResourcePath(const std::string & name_, EResType type_):
 	type(type_),
-	name(readName(name_, true)),
+	name(intern(readName(name_, true))),
 	originalName(readName(name_, false))
 {}
 
 ResourcePath::ResourcePath(const JsonNode & name, EResType type):
 	type(type),
-	name(readName(name.String(), true)),
+	name(intern(readName(name.String(), true))),
 	originalName(readName(name.String(), false))
 {
 }
@@ -75,15 +92,19 @@ void ResourcePath::serializeJson(JsonSerializeFormat & handler)
 
 		if (node.isString())
 		{
-			name = readName(node.String(), true);
+			name = intern(readName(node.String(), true));
 			originalName = readName(node.String(), false);
 			return;
 		}
 	}
 
+	std::string nameString = *name;
 	handler.serializeInt("type", type);
-	handler.serializeString("name", name);
+	handler.serializeString("name", nameString);
 	handler.serializeString("originalName", originalName);
+
+	if (!handler.saving)
+		name = intern(nameString);
 }
 
 EResType EResTypeHelper::getTypeFromExtension(std::string extension)
@@ -79,6 +79,7 @@ public:
 	/// Constructs resource path based on filename and selected type. File extension is ignored
 	ResourcePath(const std::string & name, EResType type);
 
+	/// Names are interned, so equal names are always stored at the same address
 	inline bool operator==(const ResourcePath & other) const
 	{
 		return name == other.name && type == other.type;
@@ -93,30 +94,51 @@ public:
 	{
 		if (type != other.type)
 			return type < other.type;
-		return name < other.name;
+		if (name == other.name)
+			return false;
+		return *name < *other.name;
 	}
 
-	bool empty() const {return name.empty();}
-	std::string getName() const {return name;}
+	bool empty() const {return name->empty();}
+	const std::string & getName() const {return *name;}
 	std::string getOriginalName() const {return originalName;}
 	EResType getType() const {return type;}
 
+	/// Returns hash of this path. Computed from address of interned name, so it is stable only within one process
+	size_t getHash() const
+	{
+		return std::hash<const void *>()(name) ^ static_cast<size_t>(type);
+	}
+
 	void serializeJson(JsonSerializeFormat & handler);
 
 	template <typename Handler> void serialize(Handler & h)
 	{
 		h & type;
-		h & name;
+		if (h.saving)
+		{
+			std::string nameString = *name;
+			h & nameString;
+		}
+		else
+		{
+			std::string nameString;
+			h & nameString;
+			name = intern(nameString);
+		}
 		h & originalName;
 	}
 
 protected:
+	/// Returns unique, never deallocated copy of specified upper-case name
+	static const std::string * intern(const std::string & name);
+
 	 /// Specifies the resource type. EResType::OTHER if not initialized.
 	 /// Required to prevent conflicts if files with different types (e.g. text and image) have the same name.
 	EResType type;
 
 	/// Specifies the resource name. No extension so .pcx and .png can override each other, always in upper case.
-	std::string name;
+	const std::string * name;
 
 	/// name in original case
 	std::string originalName;
@@ -178,7 +200,7 @@ public:
 	ResourcePathTempl addPrefix(const std::string & prefix) const
 	{
 		ResourcePathTempl result;
-		result.name = prefix + this->getName();
+		result.name = intern(prefix + this->getName());
 		result.originalName = prefix + this->getOriginalName();
 
 		return result;
@@ -219,9 +241,7 @@ template <> struct hash<VCMI_LIB_WRAP_NAMESPACE(ResourcePath)>
 {
 	size_t operator()(const VCMI_LIB_WRAP_NAMESPACE(ResourcePath) & resourceIdent) const
 	{
-		std::hash<int> intHasher;
-		std::hash<std::string> stringHasher;
-		return stringHasher(resourceIdent.getName()) ^ intHasher(static_cast<int>(resourceIdent.getType()));
+		return resourceIdent.getHash();
 	}
 };
 }
@@ -142,9 +142,30 @@ JsonNode::JsonType JsonNode::getType() const
 	return static_cast<JsonType>(data.index());
 }
 
+const std::string * JsonNode::internModScope(const std::string & scope)
+{
+	static std::unordered_set<std::string> scopes;
+	static boost::shared_mutex scopesMutex;
+
+	if(scope.empty())
+		return nullptr;
+
+	{
+		boost::shared_lock<boost::shared_mutex> lock(scopesMutex);
+		auto it = scopes.find(scope);
+		if(it != scopes.end())
+			return &*it;
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(scopesMutex);
+	return &*scopes.insert(scope).first;
+}
+
 const std::string & JsonNode::getModScope() const
 {
-	return modScope;
+	static const std::string emptyScope;
+
+	return modScope ? *modScope : emptyScope;
 }
 
 void JsonNode::setOverrideFlag(bool value)
@@ -158,6 +179,11 @@ bool JsonNode::getOverrideFlag() const
 }
 
 void JsonNode::setModScope(const std::string & metadata, bool recursive)
+{
+	setModScope(internModScope(metadata), recursive);
+}
+
+void JsonNode::setModScope(const std::string * metadata, bool recursive)
 {
 	modScope = metadata;
 	if(recursive)
@@ -169,7 +195,7 @@ void JsonNode::setModScope(const std::string & metadata, bool recursive)
 			{
 				for(auto & node : Vector())
 				{
-					node.setModScope(metadata);
+					node.setModScope(metadata, true);
 				}
 			}
 			break;
@@ -177,7 +203,7 @@ void JsonNode::setModScope(const std::string & metadata, bool recursive)
 			{
 				for(auto & node : Struct())
 				{
-					node.second.setModScope(metadata);
+					node.second.setModScope(metadata, true);
 				}
 			}
 		}
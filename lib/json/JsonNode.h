@@ -54,11 +54,14 @@ private:
 
 	JsonData data;
 
-	/// Mod-origin of this particular field
-	std::string modScope;
+	/// Mod-origin of this particular field. Interned, since whole trees share the same scope. Null if not set
+	const std::string * modScope = nullptr;
 
 	bool overrideFlag = false;
 
+	static const std::string * internModScope(const std::string & scope);
+	void setModScope(const std::string * scope, bool recursive);
+
 public:
 	JsonNode() = default;
 
@@ -151,7 +154,17 @@ public:
 	template<typename Handler>
 	void serialize(Handler & h)
 	{
-		h & modScope;
+		if(h.saving)
+		{
+			std::string scope = getModScope();
+			h & scope;
+		}
+		else
+		{
+			std::string scope;
+			h & scope;
+			setModScope(scope, false);
+		}
 		h & overrideFlag;
 		h & data;
 	}
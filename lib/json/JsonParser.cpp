@@ -188,6 +188,40 @@ bool JsonParser::extractEscaping(std::string & str)
 	return true;
 }
 
+/// Returns position of first character in range that requires special handling inside string:
+/// string terminator, escaping or control character. Tests 8 characters at once
+static size_t findSpecialCharacter(const char * data, size_t size, char terminator)
+{
+	constexpr uint64_t lowBits = 0x0101010101010101ULL;
+	constexpr uint64_t highBits = 0x8080808080808080ULL;
+
+	const uint64_t terminators = lowBits * static_cast<ui8>(terminator);
+	const uint64_t backslashes = lowBits * static_cast<ui8>('\\');
+
+	size_t position = 0;
+	for(; position + sizeof(uint64_t) <= size; position += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, data + position, sizeof(word));
+
+		// classic "has zero byte" tests, see "Bit Twiddling Hacks" by Sean Anderson
+		uint64_t isTerminator = ((word ^ terminators) - lowBits) & ~(word ^ terminators);
+		uint64_t isBackslash = ((word ^ backslashes) - lowBits) & ~(word ^ backslashes);
+		uint64_t isControl = (word - lowBits * ' ') & ~word;
+
+		if((isTerminator | isBackslash | isControl) & highBits)
+			break;
+	}
+
+	for(; position < size; ++position)
+	{
+		char c = data[position];
+		if(c == terminator || c == '\\' || static_cast<unsigned char>(c) < ' ')
+			return position;
+	}
+	return size;
+}
+
 bool JsonParser::extractString(std::string & str)
 {
 	//TODO: JSON5 - line breaks escaping
@@ -210,6 +244,11 @@ bool JsonParser::extractString(std::string & str)
 
 	while(pos != input.size())
 	{
+		// skip to next character that needs any processing
+		pos += findSpecialCharacter(input.data() + pos, input.size() - pos, lineTerminator);
+		if(pos == input.size())
+			break;
+
 		if(input[pos] == lineTerminator) // Correct end of string
 		{
 			str.append(&input[first], pos - first);
@@ -243,13 +282,10 @@ bool JsonParser::extractString(std::string & str)
 
 bool JsonParser::extractString(JsonNode & node)
 {
-	std::string str;
-	if(!extractString(str))
-		return false;
-
 	node.setType(JsonNode::JsonType::DATA_STRING);
-	node.String() = str;
-	return true;
+	// node may already hold value of duplicated key, which must be replaced
+	node.String().clear();
+	return extractString(node.String());
 }
 
 bool JsonParser::extractLiteral(std::string & literal)
@@ -272,6 +308,17 @@ bool JsonParser::extractLiteral(std::string & literal)
 
 bool JsonParser::extractAndCompareLiteral(const std::string & expectedLiteral)
 {
+	// fast path - literal is followed by character that can't be part of literal
+	if(input.substr(pos, expectedLiteral.size()) == expectedLiteral)
+	{
+		size_t end = pos + expectedLiteral.size();
+		if(end == input.size() || !std::isalnum(static_cast<unsigned char>(input[end])))
+		{
+			pos = end;
+			return true;
+		}
+	}
+
 	std::string literal;
 	if(!extractLiteral(literal))
 		return false;
@@ -380,16 +427,17 @@ bool JsonParser::extractStruct(JsonNode & node)
 			}
 		}
 
-		if(node.Struct().find(key) != node.Struct().end())
+		auto [entry, inserted] = node.Struct().try_emplace(std::move(key));
+		if(!inserted)
 			error("Duplicate element encountered!", true);
 
 		if(!extractSeparator())
 			return false;
 
-		if(!extractElement(node.Struct()[key], '}'))
+		if(!extractElement(entry->second, '}'))
 			return false;
 
-		node.Struct()[key].setOverrideFlag(overrideFlag);
+		entry->second.setOverrideFlag(overrideFlag);
 
 		if(input[pos] == '}')
 		{
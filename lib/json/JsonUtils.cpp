@@ -105,6 +105,10 @@ void JsonUtils::maximize(JsonNode & node, const std::string & schemaName)
 
 bool JsonUtils::validate(const JsonNode & node, const std::string & schemaName, const std::string & dataName)
 {
+	// error messages are generated only for invalid data
+	if (JsonValidator::isValid(schemaName, node))
+		return true;
+
 	JsonValidator validator;
 	std::string log = validator.check(schemaName, node);
 	if (!log.empty())
@@ -120,6 +124,9 @@ const JsonNode & getSchemaByName(const std::string & name)
 {
 	// cached schemas to avoid loading json data multiple times
 	static std::map<std::string, JsonNode> loadedSchemas;
+	// validation may run on several network threads at once, e.g. in lobby server
+	static std::mutex smx;
+	std::lock_guard lock(smx);
 
 	if (vstd::contains(loadedSchemas, name))
 		return loadedSchemas[name];
@@ -250,7 +257,7 @@ JsonNode JsonUtils::assembleFromFiles(const std::vector<std::string> & files, bo
 			bool isValidFile = false;
 			JsonNode section(JsonPath::builtinTODO(file), isValidFile);
 			merge(result, section);
-			isValid |= isValidFile;
+			isValid &= isValidFile;
 		}
 		else
 		{
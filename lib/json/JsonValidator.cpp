@@ -669,4 +669,430 @@ const JsonValidator::TFormatMap & JsonValidator::getKnownFormats()
 	return knownFormats;
 }
 
+/// Schema, compiled for quick validation. Mirrors behavior of checks used by JsonValidator::check
+struct JsonCompiledSchema
+{
+	using SchemaPtr = const JsonCompiledSchema *;
+
+	struct Dependency
+	{
+		std::string name;
+		std::vector<std::string> requiredFields; // if dependency is list of properties
+		SchemaPtr schema = nullptr; // if dependency is schema
+	};
+
+	/// set for entries that always fail validation, such as not implemented checks or unknown types
+	bool alwaysFails = false;
+	bool failsOnString = false;
+	bool failsOnStruct = false;
+
+	// common checks
+	SchemaPtr reference = nullptr;
+	SchemaPtr notSchema = nullptr;
+	std::vector<SchemaPtr> allOf;
+	std::vector<SchemaPtr> anyOf;
+	std::vector<SchemaPtr> oneOf;
+	const JsonVector * enumValues = nullptr;
+	const JsonNode * constValue = nullptr;
+	const JsonValidator::TFormatValidator * format = nullptr;
+	std::optional<JsonNode::JsonType> type;
+
+	// number checks
+	std::optional<double> maximum;
+	std::optional<double> minimum;
+	std::optional<double> exclusiveMaximum;
+	std::optional<double> exclusiveMinimum;
+	std::optional<si64> multipleOf;
+
+	// string checks
+	std::optional<double> maxLength;
+	std::optional<double> minLength;
+
+	// vector checks
+	bool hasItemsList = false;
+	SchemaPtr items = nullptr;
+	std::vector<SchemaPtr> itemsList;
+	SchemaPtr additionalItems = nullptr;
+	bool forbidAdditionalItems = false;
+	std::optional<double> minItems;
+	std::optional<double> maxItems;
+
+	// struct checks
+	std::map<std::string, SchemaPtr> properties; // nullptr if property has no schema
+	SchemaPtr additionalProperties = nullptr;
+	bool forbidAdditionalProperties = false;
+	bool uniqueProperties = false;
+	std::optional<double> minProperties;
+	std::optional<double> maxProperties;
+	std::vector<std::string> required;
+	std::vector<Dependency> dependencies;
+
+	bool matches(const JsonNode & data) const;
+	bool matchesNumber(const JsonNode & data) const;
+	bool matchesString(const JsonNode & data) const;
+	bool matchesVector(const JsonNode & data) const;
+	bool matchesStruct(const JsonNode & data) const;
+};
+
+/// Compiles schemas and keeps them until shutdown. Like schema cache in JsonUtils, not thread-safe
+class JsonSchemaCompiler
+{
+	std::map<std::string, std::unique_ptr<JsonCompiledSchema>> referencedSchemas;
+	std::vector<std::unique_ptr<JsonCompiledSchema>> inlineSchemas;
+
+	static std::optional<double> readNumber(const JsonNode & schema, const std::string & name)
+	{
+		const JsonNode & node = schema[name];
+		if (node.isNull())
+			return std::nullopt;
+		return node.Float();
+	}
+
+	std::vector<JsonCompiledSchema::SchemaPtr> compileList(const JsonNode & schemas, const std::string & baseURI)
+	{
+		std::vector<JsonCompiledSchema::SchemaPtr> result;
+		for(const auto & entry : schemas.Vector())
+			result.push_back(compile(entry, baseURI));
+		return result;
+	}
+
+	void fill(JsonCompiledSchema & result, const JsonNode & schema, const std::string & baseURI)
+	{
+		static const std::unordered_map<std::string, JsonNode::JsonType> stringToType =
+		{
+			{"null",   JsonNode::JsonType::DATA_NULL},
+			{"boolean", JsonNode::JsonType::DATA_BOOL},
+			{"number", JsonNode::JsonType::DATA_FLOAT},
+			{"integer", JsonNode::JsonType::DATA_INTEGER},
+			{"string",  JsonNode::JsonType::DATA_STRING},
+			{"array",  JsonNode::JsonType::DATA_VECTOR},
+			{"object",  JsonNode::JsonType::DATA_STRUCT}
+		};
+
+		if (!schema.isStruct())
+			return;
+
+		for (const auto & field : { "propertyNames", "contains", "examples" })
+			if (schema.Struct().count(field))
+				result.alwaysFails = true;
+
+		result.failsOnString = schema.Struct().count("pattern") != 0;
+		result.failsOnStruct = schema.Struct().count("patternProperties") != 0;
+
+		if (schema.Struct().count("type"))
+		{
+			auto it = stringToType.find(schema["type"].String());
+			if (it == stringToType.end())
+				result.alwaysFails = true;
+			else
+				result.type = it->second;
+		}
+
+		if (schema.Struct().count("format"))
+		{
+			JsonValidator validator;
+			const auto & formats = validator.getKnownFormats();
+			auto it = formats.find(schema["format"].String());
+			if (it == formats.end())
+				result.alwaysFails = true;
+			else
+				result.format = &it->second;
+		}
+
+		if (schema.Struct().count("$ref"))
+		{
+			std::string URI = schema["$ref"].String();
+			// local reference, relative to schema that is currently used
+			if (boost::algorithm::starts_with(URI, "#"))
+				URI = baseURI.substr(0, baseURI.find('#')) + URI;
+			result.reference = compileReference(URI);
+		}
+
+		if (schema.Struct().count("enum"))
+			result.enumValues = &schema["enum"].Vector();
+		if (schema.Struct().count("const"))
+			result.constValue = &schema["const"];
+		if (schema.Struct().count("not"))
+			result.notSchema = compile(schema["not"], baseURI);
+
+		result.allOf = compileList(schema["allOf"], baseURI);
+		result.anyOf = compileList(schema["anyOf"], baseURI);
+		result.oneOf = compileList(schema["oneOf"], baseURI);
+
+		result.maximum = readNumber(schema, "maximum");
+		result.minimum = readNumber(schema, "minimum");
+		result.exclusiveMaximum = readNumber(schema, "exclusiveMaximum");
+		result.exclusiveMinimum = readNumber(schema, "exclusiveMinimum");
+		if (schema.Struct().count("multipleOf"))
+			result.multipleOf = schema["multipleOf"].Integer();
+
+		result.maxLength = readNumber(schema, "maxLength");
+		result.minLength = readNumber(schema, "minLength");
+
+		const JsonNode & items = schema["items"];
+		if (items.isVector())
+		{
+			result.hasItemsList = true;
+			result.itemsList = compileList(items, baseURI);
+		}
+		else if (!items.isNull())
+			result.items = compile(items, baseURI);
+
+		const JsonNode & additionalItems = schema["additionalItems"];
+		if (additionalItems.isStruct())
+			result.additionalItems = compile(additionalItems, baseURI);
+		else if (!additionalItems.isNull() && !additionalItems.Bool())
+			result.forbidAdditionalItems = true;
+
+		result.minItems = readNumber(schema, "minItems");
+		result.maxItems = readNumber(schema, "maxItems");
+
+		for(const auto & property : schema["properties"].Struct())
+			result.properties[property.first] = property.second.isNull() ? nullptr : compile(property.second, baseURI);
+
+		const JsonNode & additionalProperties = schema["additionalProperties"];
+		if (additionalProperties.isStruct())
+			result.additionalProperties = compile(additionalProperties, baseURI);
+		else if (!additionalProperties.isNull() && !additionalProperties.Bool())
+			result.forbidAdditionalProperties = true;
+
+		result.uniqueProperties = schema.Struct().count("uniqueProperties") != 0;
+		result.minProperties = readNumber(schema, "minProperties");
+		result.maxProperties = readNumber(schema, "maxProperties");
+
+		for(const auto & entry : schema["required"].Vector())
+			result.required.push_back(entry.String());
+
+		for(const auto & entry : schema["dependencies"].Struct())
+		{
+			JsonCompiledSchema::Dependency dependency;
+			dependency.name = entry.first;
+
+			if (entry.second.isVector())
+			{
+				for(const auto & field : entry.second.Vector())
+					dependency.requiredFields.push_back(field.String());
+			}
+			else
+				dependency.schema = compile(entry.second, baseURI);
+
+			result.dependencies.push_back(dependency);
+		}
+	}
+
+public:
+	JsonCompiledSchema::SchemaPtr compile(const JsonNode & schema, const std::string & baseURI)
+	{
+		inlineSchemas.push_back(std::make_unique<JsonCompiledSchema>());
+		JsonCompiledSchema * result = inlineSchemas.back().get();
+		fill(*result, schema, baseURI);
+		return result;
+	}
+
+	JsonCompiledSchema::SchemaPtr compileReference(const std::string & URI)
+	{
+		auto it = referencedSchemas.find(URI);
+		if (it != referencedSchemas.end())
+			return it->second.get();
+
+		// register schema before compilation to support recursive references
+		JsonCompiledSchema * result = new JsonCompiledSchema();
+		referencedSchemas[URI].reset(result);
+		fill(*result, JsonUtils::getSchema(URI), URI);
+		return result;
+	}
+};
+
+bool JsonCompiledSchema::matches(const JsonNode & data) const
+{
+	if (alwaysFails)
+		return false;
+
+	if (reference && !reference->matches(data))
+		return false;
+
+	if (notSchema && notSchema->matches(data))
+		return false;
+
+	for(const auto & schema : allOf)
+		if (!schema->matches(data))
+			return false;
+
+	if (!anyOf.empty() && std::none_of(anyOf.begin(), anyOf.end(), [&data](SchemaPtr schema){ return schema->matches(data); }))
+		return false;
+
+	if (!oneOf.empty() && std::count_if(oneOf.begin(), oneOf.end(), [&data](SchemaPtr schema){ return schema->matches(data); }) != 1)
+		return false;
+
+	if (enumValues && std::find(enumValues->begin(), enumValues->end(), data) == enumValues->end())
+		return false;
+
+	if (constValue && !(data == *constValue))
+		return false;
+
+	if (format && (!data.isString() || !(*format)(data).empty()))
+		return false;
+
+	if (type)
+	{
+		// for "number" type both float and integer are allowed
+		bool numberMatches = *type == JsonNode::JsonType::DATA_FLOAT && data.isNumber();
+		if (!numberMatches && *type != data.getType() && !data.isNull())
+			return false;
+	}
+
+	switch (data.getType())
+	{
+		case JsonNode::JsonType::DATA_FLOAT:
+		case JsonNode::JsonType::DATA_INTEGER:
+			return matchesNumber(data);
+		case JsonNode::JsonType::DATA_STRING:
+			return matchesString(data);
+		case JsonNode::JsonType::DATA_VECTOR:
+			return matchesVector(data);
+		case JsonNode::JsonType::DATA_STRUCT:
+			return matchesStruct(data);
+		default:
+			return true;
+	}
+}
+
+bool JsonCompiledSchema::matchesNumber(const JsonNode & data) const
+{
+	double value = data.Float();
+
+	if (maximum && value > *maximum)
+		return false;
+	if (minimum && value < *minimum)
+		return false;
+	if (exclusiveMaximum && value >= *exclusiveMaximum)
+		return false;
+	if (exclusiveMinimum && value <= *exclusiveMinimum)
+		return false;
+
+	if (multipleOf)
+	{
+		double result = data.Integer() / *multipleOf;
+		if (!vstd::isAlmostEqual(floor(result), result))
+			return false;
+	}
+	return true;
+}
+
+bool JsonCompiledSchema::matchesString(const JsonNode & data) const
+{
+	if (failsOnString)
+		return false;
+	if (maxLength && data.String().size() > *maxLength)
+		return false;
+	if (minLength && data.String().size() < *minLength)
+		return false;
+	return true;
+}
+
+bool JsonCompiledSchema::matchesVector(const JsonNode & data) const
+{
+	const auto & vector = data.Vector();
+
+	if (maxItems && vector.size() > *maxItems)
+		return false;
+	if (minItems && vector.size() < *minItems)
+		return false;
+
+	for (size_t i = 0; i < vector.size(); ++i)
+	{
+		if (!hasItemsList)
+		{
+			if (items && !items->matches(vector[i]))
+				return false;
+			continue;
+		}
+
+		if (i < itemsList.size())
+		{
+			if (!itemsList[i]->matches(vector[i]))
+				return false;
+			continue;
+		}
+
+		if (forbidAdditionalItems)
+			return false;
+		if (additionalItems && !additionalItems->matches(vector[i]))
+			return false;
+	}
+	return true;
+}
+
+bool JsonCompiledSchema::matchesStruct(const JsonNode & data) const
+{
+	const auto & map = data.Struct();
+
+	if (failsOnStruct)
+		return false;
+	if (maxProperties && map.size() > *maxProperties)
+		return false;
+	if (minProperties && map.size() < *minProperties)
+		return false;
+
+	for(const auto & name : required)
+		if (data[name].isNull())
+			return false;
+
+	// both maps are sorted, so entries can be matched to their schemas in one pass
+	auto property = properties.begin();
+	for(const auto & entry : map)
+	{
+		while (property != properties.end() && property->first < entry.first)
+			++property;
+
+		if (property != properties.end() && property->first == entry.first)
+		{
+			if (property->second && !property->second->matches(entry.second))
+				return false;
+			continue;
+		}
+
+		if (forbidAdditionalProperties)
+			return false;
+		if (additionalProperties && !additionalProperties->matches(entry.second))
+			return false;
+	}
+
+	for(const auto & dependency : dependencies)
+	{
+		if (data[dependency.name].isNull())
+			continue;
+
+		for(const auto & field : dependency.requiredFields)
+			if (data[field].isNull())
+				return false;
+
+		if (dependency.schema && !dependency.schema->matches(data))
+			return false;
+	}
+
+	if (uniqueProperties)
+	{
+		for (auto itA = map.begin(); itA != map.end(); itA++)
+			for (auto itB = std::next(itA); itB != map.end(); itB++)
+				if (itA->second == itB->second)
+					return false;
+	}
+	return true;
+}
+
+bool JsonValidator::isValid(const std::string & schemaName, const JsonNode & data)
+{
+	static JsonSchemaCompiler compiler;
+	static std::mutex smx;
+
+	JsonCompiledSchema::SchemaPtr schema;
+	{
+		// compiled schemas are never modified after compilation, only compilation itself needs locking
+		std::lock_guard lock(smx);
+		schema = compiler.compileReference(schemaName);
+	}
+	return schema->matches(data);
+}
+
 VCMI_LIB_NAMESPACE_END
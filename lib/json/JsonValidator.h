@@ -14,7 +14,7 @@
 VCMI_LIB_NAMESPACE_BEGIN
 
 /// Class for Json validation. Mostly compliant with json-schema v6 draf
-struct JsonValidator
+struct DLL_LINKAGE JsonValidator
 {
 	/// path from root node to current one.
 	/// JsonNode is used as variant - either string (name of node) or as float (index in list)
@@ -38,6 +38,10 @@ struct JsonValidator
 
 	std::string check(const std::string & schemaName, const JsonNode & data);
 	std::string check(const JsonNode & schema, const JsonNode & data);
+
+	/// Checks data using schema compiled into tree of typed checks, with all references resolved in advance
+	/// Much faster than check(), but does not generate any error messages. Compiled schemas are cached
+	static bool isValid(const std::string & schemaName, const JsonNode & data);
 };
 
 VCMI_LIB_NAMESPACE_END
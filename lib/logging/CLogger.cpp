@@ -124,7 +124,9 @@ CLogger * CLogger::getGlobalLogger()
 	return getLogger(CLoggerDomain(CLoggerDomain::DOMAIN_GLOBAL));
 }
 
-CLogger::CLogger(const CLoggerDomain & domain) : domain(domain)
+CLogger::CLogger(const CLoggerDomain & domain)
+	: domain(domain)
+	, writer(CLogManager::get().getAsyncWriter())
 {
 	if(domain.isGlobalDomain())
 	{
@@ -136,12 +138,19 @@ CLogger::CLogger(const CLoggerDomain & domain) : domain(domain)
 		level = ELogLevel::NOT_SET;
 		parent = getLogger(domain.getParent());
 	}
+	updateEffectiveLevel();
 }
 
 void CLogger::log(ELogLevel::ELogLevel level, const std::string & message) const
 {
-	if(getEffectiveLevel() <= level)
-		callTargets(LogRecord(domain, level, message));
+	if(!isEnabled(level))
+		return;
+
+	writer.push(this, LogRecord(domain, level, message));
+
+	// errors often precede crashes, make sure that they reach the log file
+	if(level >= ELogLevel::ERROR)
+		writer.flush();
 }
 
 void CLogger::log(ELogLevel::ELogLevel level, const boost::format & fmt) const
@@ -163,9 +172,14 @@ ELogLevel::ELogLevel CLogger::getLevel() const
 
 void CLogger::setLevel(ELogLevel::ELogLevel level)
 {
-	TLockGuard _(mx);
-	if (!domain.isGlobalDomain() || level != ELogLevel::NOT_SET)
-		this->level = level;
+	{
+		TLockGuard _(mx);
+		if (!domain.isGlobalDomain() || level != ELogLevel::NOT_SET)
+			this->level = level;
+	}
+
+	// sub-domains may inherit level of this logger
+	CLogManager::get().updateEffectiveLevels();
 }
 
 const CLoggerDomain & CLogger::getDomain() const { return domain; }
@@ -177,13 +191,23 @@ void CLogger::addTarget(std::unique_ptr<ILogTarget> && target)
 }
 
 ELogLevel::ELogLevel CLogger::getEffectiveLevel() const
+{
+	return effectiveLevel.load(std::memory_order_relaxed);
+}
+
+void CLogger::updateEffectiveLevel()
 {
 	for(const CLogger * logger = this; logger != nullptr; logger = logger->parent)
+	{
 		if(logger->getLevel() != ELogLevel::NOT_SET)
-			return logger->getLevel();
+		{
+			effectiveLevel = logger->getLevel();
+			return;
+		}
+	}
 
 	// This shouldn't be reached, as the root logger must have set a log level
-	return ELogLevel::INFO;
+	effectiveLevel = ELogLevel::INFO;
 }
 
 void CLogger::callTargets(const LogRecord & record) const
@@ -196,12 +220,16 @@ void CLogger::callTargets(const LogRecord & record) const
 
 void CLogger::clearTargets()
 {
+	// pending records must still reach targets that were active when they were logged
+	writer.flush();
+
 	TLockGuard _(mx);
 	targets.clear();
 }
 
 bool CLogger::isDebugEnabled() const { return getEffectiveLevel() <= ELogLevel::DEBUG; }
 bool CLogger::isTraceEnabled() const { return getEffectiveLevel() <= ELogLevel::TRACE; }
+bool CLogger::isEnabled(ELogLevel::ELogLevel level) const { return getEffectiveLevel() <= level; }
 
 CLogManager & CLogManager::get()
 {
@@ -210,13 +238,33 @@ CLogManager & CLogManager::get()
 	return instance;
 }
 
-CLogManager::CLogManager() = default;
+CLogManager::CLogManager()
+	: asyncWriter(std::make_unique<CLogAsyncWriter>())
+{
+}
+
 CLogManager::~CLogManager()
 {
+	// write all pending records while their loggers are still alive
+	// writer itself is destroyed only after loggers, since each of them refers to it
+	asyncWriter->stop();
+
 	for(auto & i : loggers)
 		delete i.second;
 }
 
+CLogAsyncWriter & CLogManager::getAsyncWriter()
+{
+	return *asyncWriter;
+}
+
+void CLogManager::updateEffectiveLevels()
+{
+	TLockGuard _(mx);
+	for(auto & i : loggers)
+		i.second->updateEffectiveLevel();
+}
+
 void CLogManager::addLogger(CLogger * logger)
 {
 	TLockGuard _(mx);
@@ -244,6 +292,172 @@ std::vector<std::string> CLogManager::getRegisteredDomains() const
 	return domains;
 }
 
+CLogAsyncWriter::CLogAsyncWriter()
+	: buffer(std::make_unique<Entry[]>(bufferSize))
+	, pushPosition(0)
+	, popPosition(0)
+	, recordsPushed(0)
+	, recordsWritten(0)
+	, writerSleeping(false)
+	, stopping(false)
+	, flushWaiters(0)
+{
+	for(size_t i = 0; i < bufferSize; ++i)
+		buffer[i].sequence = i;
+}
+
+CLogAsyncWriter::~CLogAsyncWriter()
+{
+	stop();
+}
+
+void CLogAsyncWriter::stop()
+{
+	stopping = true;
+	wakeWriter();
+
+	if(writerThread.joinable())
+		writerThread.join();
+}
+
+void CLogAsyncWriter::push(const CLogger * logger, LogRecord && record)
+{
+	if(writerThreadId.load() == boost::this_thread::get_id() || stopping)
+	{
+		// record logged by one of targets, writer thread can't wait for itself
+		// or record logged during shutdown, when there is no writer thread
+		logger->callTargets(record);
+		return;
+	}
+
+	std::call_once(writerStarted, [this]()
+	{
+		writerThread = boost::thread(&CLogAsyncWriter::run, this);
+	});
+
+	recordsPushed += 1;
+	while(!tryPush(logger, record))
+	{
+		wakeWriter();
+		boost::this_thread::yield();
+	}
+
+	if(writerSleeping)
+		wakeWriter();
+}
+
+void CLogAsyncWriter::flush()
+{
+	if(writerThreadId.load() == boost::this_thread::get_id())
+		return;
+
+	uint64_t target = recordsPushed;
+	if(recordsWritten >= target)
+		return;
+
+	flushWaiters += 1;
+	wakeWriter();
+	{
+		std::unique_lock<std::mutex> lock(flushMutex);
+		flushCondition.wait(lock, [this, target]()
+		{
+			return recordsWritten >= target || stopping;
+		});
+	}
+	flushWaiters -= 1;
+}
+
+bool CLogAsyncWriter::tryPush(const CLogger * logger, LogRecord & record)
+{
+	// bounded queue with per-entry sequence numbers, see "Bounded MPMC queue" by Dmitry Vyukov
+	size_t position = pushPosition.load(std::memory_order_relaxed);
+	Entry * entry;
+
+	while(true)
+	{
+		entry = &buffer[position & (bufferSize - 1)];
+		size_t sequence = entry->sequence.load(std::memory_order_acquire);
+		auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if(difference == 0)
+		{
+			if(pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if(difference < 0)
+			return false; // buffer is full
+		else
+			position = pushPosition.load(std::memory_order_relaxed);
+	}
+
+	entry->logger = logger;
+	entry->record = std::move(record);
+	entry->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool CLogAsyncWriter::tryPop(const CLogger *& logger, std::optional<LogRecord> & record)
+{
+	Entry & entry = buffer[popPosition & (bufferSize - 1)];
+
+	if(entry.sequence.load(std::memory_order_acquire) != popPosition + 1)
+		return false; // buffer is empty
+
+	logger = entry.logger;
+	record = std::move(entry.record);
+	entry.record.reset();
+	entry.sequence.store(popPosition + bufferSize, std::memory_order_release);
+	popPosition += 1;
+	return true;
+}
+
+void CLogAsyncWriter::wakeWriter()
+{
+	std::lock_guard<std::mutex> lock(wakeMutex);
+	wakeCondition.notify_one();
+}
+
+void CLogAsyncWriter::run()
+{
+	setThreadName("logWriter");
+	writerThreadId = boost::this_thread::get_id();
+
+	const CLogger * logger = nullptr;
+	std::optional<LogRecord> record;
+
+	while(true)
+	{
+		if(tryPop(logger, record))
+		{
+			logger->callTargets(*record);
+			record.reset();
+			recordsWritten += 1;
+
+			if(flushWaiters > 0)
+			{
+				std::lock_guard<std::mutex> lock(flushMutex);
+				flushCondition.notify_all();
+			}
+			continue;
+		}
+
+		if(stopping)
+		{
+			std::lock_guard<std::mutex> lock(flushMutex);
+			flushCondition.notify_all();
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		writerSleeping = true;
+		wakeCondition.wait_for(lock, std::chrono::milliseconds(100), [this]()
+		{
+			return stopping || buffer[popPosition & (bufferSize - 1)].sequence.load(std::memory_order_acquire) == popPosition + 1;
+		});
+		writerSleeping = false;
+	}
+}
+
 CLogFormatter::CLogFormatter()
 	: CLogFormatter("%m")
 {
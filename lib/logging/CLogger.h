@@ -11,11 +11,14 @@
 
 #include "../CConsoleHandler.h"
 
+#include <condition_variable>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class CLogger;
 struct LogRecord;
 class ILogTarget;
+class CLogAsyncWriter;
 
 
 namespace ELogLevel
@@ -67,15 +70,22 @@ public:
 	/// Useful if performance is important and concatenating the log message is a expensive task.
 	bool isDebugEnabled() const override;
 	bool isTraceEnabled() const override;
+	bool isEnabled(ELogLevel::ELogLevel level) const override;
 
 private:
+	friend class CLogManager;
+	friend class CLogAsyncWriter;
+
 	explicit CLogger(const CLoggerDomain & domain);
 	inline ELogLevel::ELogLevel getEffectiveLevel() const; /// Returns the log level applied on this logger whether directly or indirectly.
-	inline void callTargets(const LogRecord & record) const;
+	void updateEffectiveLevel(); /// Must be called whenever level of this logger or of any of its parents changes
+	void callTargets(const LogRecord & record) const;
 
 	CLoggerDomain domain;
 	CLogger * parent;
-	ELogLevel::ELogLevel level;
+	CLogAsyncWriter & writer; /// owned by CLogManager, which destroys it only after all loggers
+	std::atomic<ELogLevel::ELogLevel> level;
+	std::atomic<ELogLevel::ELogLevel> effectiveLevel; /// cached, so level check of disabled messages is as cheap as possible
 	std::vector<std::unique_ptr<ILogTarget> > targets;
 	mutable std::mutex mx;
 	static std::recursive_mutex smx;
@@ -94,11 +104,15 @@ public:
 	void addLogger(CLogger * logger);
 	CLogger * getLogger(const CLoggerDomain & domain); /// Returns a logger or nullptr if no one is registered for the given domain.
 	std::vector<std::string> getRegisteredDomains() const;
+	void updateEffectiveLevels();
+
+	CLogAsyncWriter & getAsyncWriter();
 
 private:
 	CLogManager();
 	virtual ~CLogManager();
 
+	std::unique_ptr<CLogAsyncWriter> asyncWriter;
 	std::map<std::string, CLogger *> loggers;
 	mutable std::mutex mx;
 	static std::recursive_mutex smx;
@@ -116,6 +130,58 @@ struct DLL_LINKAGE LogRecord
 	std::string threadId;
 };
 
+/// Passes log records to targets of their loggers on a background thread, so logging threads are never blocked by slow output.
+/// Records are queued in fixed size lock-free ring buffer. If buffer is full, logging thread waits until it has free space.
+class DLL_LINKAGE CLogAsyncWriter : public boost::noncopyable
+{
+public:
+	CLogAsyncWriter();
+	~CLogAsyncWriter();
+
+	/// Writes all pending records and stops background thread. Records pushed after that are written immediately
+	void stop();
+
+	void push(const CLogger * logger, LogRecord && record);
+
+	/// Waits until all records pushed so far have been written to targets
+	void flush();
+
+private:
+	struct Entry
+	{
+		std::atomic<size_t> sequence;
+		const CLogger * logger = nullptr;
+		std::optional<LogRecord> record;
+	};
+
+	static constexpr size_t bufferSize = 8192; // must be power of two
+
+	bool tryPush(const CLogger * logger, LogRecord & record);
+	bool tryPop(const CLogger *& logger, std::optional<LogRecord> & record);
+	void wakeWriter();
+	void run();
+
+	std::unique_ptr<Entry[]> buffer;
+	std::atomic<size_t> pushPosition;
+	size_t popPosition; /// only accessed by writer thread
+
+	std::atomic<uint64_t> recordsPushed;
+	std::atomic<uint64_t> recordsWritten;
+	std::atomic<bool> writerSleeping;
+	std::atomic<bool> stopping;
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+
+	std::atomic<int> flushWaiters;
+	std::mutex flushMutex;
+	std::condition_variable flushCondition;
+
+	std::once_flag writerStarted;
+	boost::thread writerThread;
+	std::atomic<boost::thread::id> writerThreadId; /// set by writer thread itself, so it can be read while writerThread is being assigned
+};
+
 /// The class CLogFormatter formats log records.
 ///
 /// There are several pattern characters which can be used to format a log record:
@@ -202,6 +202,9 @@ std::vector<std::string> CModHandler::getModList(const std::string & path) const
 		if (!name.empty())
 			foundMods.push_back(name);
 	}
+
+	// order of files in filesystem is not stable between runs
+	std::sort(foundMods.begin(), foundMods.end());
 	return foundMods;
 }
 
@@ -315,7 +318,11 @@ static ui32 calculateModChecksum(const std::string & modName, ISimpleResourceLoa
 			   ( boost::starts_with(resID.getName(), "DATA") || boost::starts_with(resID.getName(), "CONFIG"));
 	});
 
-	for (const ResourcePath & file : files)
+	// checksum depends on order of files, while order of files in filesystem is not stable between runs
+	std::vector<ResourcePath> sortedFiles(files.begin(), files.end());
+	std::sort(sortedFiles.begin(), sortedFiles.end());
+
+	for (const ResourcePath & file : sortedFiles)
 	{
 		ui32 fileChecksum = filesystem->load(file)->calculateCRC32();
 		modChecksum.process_bytes(reinterpret_cast<const void *>(&fileChecksum), sizeof(fileChecksum));
@@ -462,9 +469,11 @@ void CModHandler::load()
 
 	// first - load virtual builtin mod that contains all data
 	// TODO? move all data into real mods? RoE, AB, SoD, WoG
-	content->preloadData(*coreMod);
+	std::vector<CModInfo *> preloadedMods = { coreMod.get() };
 	for(const TModID & modName : activeMods)
-		content->preloadData(allMods[modName]);
+		preloadedMods.push_back(&allMods[modName]);
+
+	content->preloadData(preloadedMods);
 	logMod->info("\tParsing mod data: %d ms", timer.getDiff());
 
 	content->load(*coreMod);
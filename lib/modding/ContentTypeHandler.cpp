@@ -34,9 +34,15 @@
 #include "../json/JsonUtils.h"
 #include "../mapObjectConstructors/CObjectClassesHandler.h"
 #include "../rmg/CRmgTemplateStorage.h"
+#include "../filesystem/Filesystem.h"
+#include "../serializer/CLoadFile.h"
+#include "../serializer/CSaveFile.h"
 #include "../spells/CSpellHandler.h"
+#include "../VCMIDirs.h"
 #include "../VCMI_Lib.h"
 
+#include <tbb/parallel_for.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler, const std::string & objectName):
@@ -50,10 +56,8 @@ ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler, const std::string
 	}
 }
 
-bool ContentTypeHandler::preloadModData(const std::string & modName, const std::vector<std::string> & fileList, bool validate)
+bool ContentTypeHandler::preloadModData(const std::string & modName, JsonNode data, bool validate)
 {
-	bool result = false;
-	JsonNode data = JsonUtils::assembleFromFiles(fileList, result);
 	data.setModScope(modName);
 
 	ModInfo & modInfo = modData[modName];
@@ -82,7 +86,7 @@ bool ContentTypeHandler::preloadModData(const std::string & modName, const std::
 			JsonUtils::merge(remoteConf, entry.second);
 		}
 	}
-	return result;
+	return true;
 }
 
 bool ContentTypeHandler::loadMod(const std::string & modName, bool validate)
@@ -211,12 +215,118 @@ void CContentHandler::init()
 	handlers.insert(std::make_pair("biomes", ContentTypeHandler(VLC->biomeHandler.get(), "biome")));
 }
 
-bool CContentHandler::preloadModData(const std::string & modName, JsonNode modConfig, bool validate)
+static const std::string MOD_CACHE_MAGIC = "VCMIMODCACHE";
+
+/// Describes every file used by mod without reading it: resolved location, size and modification time
+/// Files that are not present in file system as is (e.g. located in archives) are described by their checksum instead
+static std::vector<std::string> getModCacheKey(const std::vector<std::string> & files)
+{
+	std::vector<std::string> result;
+
+	for(const auto & file : files)
+	{
+		JsonPath path = JsonPath::builtinTODO(file);
+		std::string entry = path.getName();
+
+		auto physicalPath = CResourceHandler::get()->getResourceName(path);
+		boost::system::error_code ec;
+
+		if (physicalPath && boost::filesystem::is_regular_file(*physicalPath, ec))
+		{
+			auto size = boost::filesystem::file_size(*physicalPath, ec);
+			auto modificationTime = boost::filesystem::last_write_time(*physicalPath, ec);
+			entry += "|" + physicalPath->string() + "|" + std::to_string(size) + "|" + std::to_string(modificationTime);
+		}
+		else if (CResourceHandler::get()->existsResource(path))
+		{
+			auto stream = CResourceHandler::get()->load(path);
+			entry += "|" + std::to_string(stream->getSize()) + "|" + std::to_string(stream->calculateCRC32());
+		}
+
+		result.push_back(entry);
+	}
+	return result;
+}
+
+std::map<std::string, JsonNode> CContentHandler::assembleModData(const std::string & modName, const JsonNode & modConfig, bool & isValid) const
+{
+	// cache is valid only if every file used by mod is unchanged since the run that created it,
+	// and only for the same build of the game, since parsing and serialization of json may change between versions
+	// Key is stored in cache as is and compared in full, so different content can not be mistaken for cached one
+	std::vector<std::string> cacheKey;
+	cacheKey.push_back(GameConstants::VCMI_VERSION);
+	cacheKey.push_back(std::to_string(static_cast<int>(ESerializationVersion::CURRENT)));
+
+	for(const auto & handler : handlers)
+	{
+		cacheKey.push_back(handler.first);
+		vstd::concatenate(cacheKey, getModCacheKey(modConfig[handler.first].convertTo<std::vector<std::string>>()));
+	}
+
+	const auto cachePath = VCMIDirs::get().userCachePath() / "ModCache" / (modName + ".vcache");
+	std::map<std::string, JsonNode> result;
+
+	try
+	{
+		if (boost::filesystem::exists(cachePath))
+		{
+			CLoadFile cacheFile(cachePath);
+			std::vector<std::string> cachedKey;
+
+			cacheFile.checkMagicBytes(MOD_CACHE_MAGIC);
+			cacheFile >> cachedKey;
+
+			if (cachedKey == cacheKey)
+			{
+				cacheFile >> result;
+				isValid = true;
+				logMod->trace("Loaded content of mod %s from cache", modName);
+				return result;
+			}
+		}
+	}
+	catch(const std::exception & e)
+	{
+		logMod->warn("Failed to load content cache of mod %s: %s", modName, e.what());
+		result.clear();
+	}
+
+	isValid = true;
+	for(const auto & handler : handlers)
+	{
+		bool isValidHandler = false;
+		result[handler.first] = JsonUtils::assembleFromFiles(modConfig[handler.first].convertTo<std::vector<std::string>>(), isValidHandler);
+		isValid &= isValidHandler;
+	}
+
+	// do not cache broken mods, so errors are reported again on next run
+	if (!isValid)
+		return result;
+
+	try
+	{
+		boost::filesystem::create_directories(cachePath.parent_path());
+
+		CSaveFile cacheFile(cachePath);
+		cacheFile.putMagicBytes(MOD_CACHE_MAGIC);
+		cacheFile << cacheKey;
+		cacheFile << result;
+		cacheFile.writeToDisk();
+	}
+	catch(const std::exception & e)
+	{
+		logMod->warn("Failed to save content cache of mod %s: %s", modName, e.what());
+	}
+
+	return result;
+}
+
+bool CContentHandler::preloadModData(const std::string & modName, std::map<std::string, JsonNode> modData, bool validate)
 {
 	bool result = true;
 	for(auto & handler : handlers)
 	{
-		result &= handler.second.preloadModData(modName, modConfig[handler.first].convertTo<std::vector<std::string> >(), validate);
+		result &= handler.second.preloadModData(modName, std::move(modData[handler.first]), validate);
 	}
 	return result;
 }
@@ -247,21 +357,67 @@ void CContentHandler::afterLoadFinalization()
 	}
 }
 
-void CContentHandler::preloadData(CModInfo & mod)
+void CContentHandler::preloadData(const std::vector<CModInfo *> & mods)
 {
-	bool validate = (mod.validation != CModInfo::PASSED);
+	using Clock = std::chrono::steady_clock;
+
+	struct AssembledMod
+	{
+		std::map<std::string, JsonNode> data;
+		bool isValid = true;
+		double parseMilliseconds = 0;
+		double mergeMilliseconds = 0;
+	};
 
-	// print message in format [<8-symbols checksum>] <modname>
-	auto & info = mod.getVerificationInfo();
-	logMod->info("\t\t[%08x]%s", info.checksum, info.name);
+	std::vector<AssembledMod> assembled(mods.size());
 
-	if (validate && mod.identifier != ModScope::scopeBuiltin())
+	for(auto * mod : mods)
 	{
-		if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
+		// print message in format [<8-symbols checksum>] <modname>
+		auto & info = mod->getVerificationInfo();
+		logMod->info("\t\t[%08x]%s", info.checksum, info.name);
+
+		if (mod->validation != CModInfo::PASSED && mod->identifier != ModScope::scopeBuiltin())
+		{
+			if (!JsonUtils::validate(mod->config, "vcmi:mod", mod->identifier))
+				mod->validation = CModInfo::FAILED;
+		}
+	}
+
+	// reading and parsing of files is independent for each mod
+	tbb::parallel_for(static_cast<size_t>(0), mods.size(), [&](size_t index)
+	{
+		auto started = Clock::now();
+		assembled[index].data = assembleModData(mods[index]->identifier, mods[index]->config, assembled[index].isValid);
+		assembled[index].parseMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+	});
+
+	// while merging must be done in order of mods, so patches are applied in the same way on every run
+	for(size_t index = 0; index < mods.size(); ++index)
+	{
+		CModInfo & mod = *mods[index];
+		bool validate = (mod.validation != CModInfo::PASSED);
+		auto started = Clock::now();
+
+		if (!assembled[index].isValid)
+			mod.validation = CModInfo::FAILED;
+
+		if (!preloadModData(mod.identifier, std::move(assembled[index].data), validate))
 			mod.validation = CModInfo::FAILED;
+
+		assembled[index].mergeMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
 	}
-	if (!preloadModData(mod.identifier, mod.config, validate))
-		mod.validation = CModInfo::FAILED;
+
+	std::vector<size_t> slowestMods(mods.size());
+	std::iota(slowestMods.begin(), slowestMods.end(), 0);
+	std::sort(slowestMods.begin(), slowestMods.end(), [&assembled](size_t left, size_t right)
+	{
+		return assembled[left].parseMilliseconds + assembled[left].mergeMilliseconds > assembled[right].parseMilliseconds + assembled[right].mergeMilliseconds;
+	});
+
+	logMod->info("\tTime spent on preloading of each mod:");
+	for(size_t index : slowestMods)
+		logMod->info("\t\t%s: parsing %d ms, merging %d ms", mods[index]->identifier, static_cast<int>(assembled[index].parseMilliseconds), static_cast<int>(assembled[index].mergeMilliseconds));
 }
 
 void CContentHandler::load(CModInfo & mod)
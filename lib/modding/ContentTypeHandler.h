@@ -39,7 +39,7 @@ public:
 
 	/// local version of methods in ContentHandler
 	/// returns true if loading was successful
-	bool preloadModData(const std::string & modName, const std::vector<std::string> & fileList, bool validate);
+	bool preloadModData(const std::string & modName, JsonNode data, bool validate);
 	bool loadMod(const std::string & modName, bool validate);
 	void loadCustom();
 	void afterLoadFinalization();
@@ -48,8 +48,12 @@ public:
 /// class used to load all game data into handlers. Used only during loading
 class DLL_LINKAGE CContentHandler
 {
-	/// preloads all data from fileList as data from modName.
-	bool preloadModData(const std::string & modName, JsonNode modConfig, bool validate);
+	/// preloads assembled data of all content types as data from modName.
+	bool preloadModData(const std::string & modName, std::map<std::string, JsonNode> modData, bool validate);
+
+	/// Assembled content of all files of mod for each handler, loaded from cache if files of mod did not change since last run
+	/// Cache holds data before merging with other mods and validation, since both depend on other loaded mods
+	std::map<std::string, JsonNode> assembleModData(const std::string & modName, const JsonNode & modConfig, bool & isValid) const;
 
 	/// actually loads data in mod
 	bool loadMod(const std::string & modName, bool validate);
@@ -59,8 +63,8 @@ class DLL_LINKAGE CContentHandler
 public:
 	void init();
 
-	/// preloads all data from fileList as data from modName.
-	void preloadData(CModInfo & mod);
+	/// preloads all data of specified mods. Files are read and parsed in parallel, but merged in order of mods in list
+	void preloadData(const std::vector<CModInfo *> & mods);
 
 	/// actually loads data in mod
 	void load(CModInfo & mod);
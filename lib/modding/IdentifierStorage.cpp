@@ -115,7 +115,10 @@ void CIdentifierStorage::requestIdentifier(ObjectCallback callback) const
 	assert(!callback.localScope.empty());
 
 	if (state != ELoadingState::FINISHED) // enqueue request if loading is still in progress
-		scheduledRequests.push_back(callback);
+	{
+		requestsScheduled++;
+		scheduledRequests.push_back(std::move(callback));
+	}
 	else // execute immediately for "late" requests
 		resolveIdentifier(callback);
 }
@@ -241,6 +244,7 @@ std::optional<si32> CIdentifierStorage::getIdentifier(const std::string & scope,
 
 std::optional<si32> CIdentifierStorage::getIdentifierImpl(const ObjectCallback & options, bool silent) const
 {
+	immediateLookups++;
 	auto idList = getPossibleIdentifiers(options);
 
 	if (idList.size() == 1)
@@ -336,11 +340,11 @@ void CIdentifierStorage::registerObject(const std::string & scope, const std::st
 	std::string fullID = type + '.' + name;
 	checkIdentifier(fullID);
 
-	std::pair<const std::string, ObjectData> mapping = std::make_pair(fullID, data);
-	if(!vstd::containsMapping(registeredObjects, mapping))
+	auto existing = registeredObjects.equal_range(fullID);
+	if(std::none_of(existing.first, existing.second, [&data](const auto & entry){ return entry.second == data; }))
 	{
 		logMod->trace("registered '%s' as %s:%s", fullID, scope, identifier);
-		registeredObjects.insert(mapping);
+		registeredObjects.emplace(std::move(fullID), data);
 	}
 	else
 	{
@@ -348,30 +352,49 @@ void CIdentifierStorage::registerObject(const std::string & scope, const std::st
 	}
 }
 
-std::vector<CIdentifierStorage::ObjectData> CIdentifierStorage::getPossibleIdentifiers(const ObjectCallback & request) const
+const std::set<std::string> & CIdentifierStorage::getAllowedScopes(const std::string & localScope, const std::string & remoteScope) const
 {
-	std::set<std::string> allowedScopes;
+	auto key = std::make_pair(localScope, remoteScope);
+
+	{
+		boost::shared_lock<boost::shared_mutex> lock(allowedScopesMutex);
+		auto cached = allowedScopesCache.find(key);
+		if (cached != allowedScopesCache.end())
+			return cached->second;
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(allowedScopesMutex);
+
+	// another thread may have computed this set while lock was released
+	auto cached = allowedScopesCache.find(key);
+	if (cached != allowedScopesCache.end())
+		return cached->second;
+
+	std::set<std::string> & allowedScopes = allowedScopesCache[key];
 	bool isValidScope = true;
 
 	// called have not specified destination mod explicitly
-	if (request.remoteScope.empty())
+	if (remoteScope.empty())
 	{
 		// special scope that should have access to all in-game objects
-		if (request.localScope == ModScope::scopeGame())
+		if (localScope == ModScope::scopeGame())
 		{
 			for(const auto & modName : VLC->modh->getActiveMods())
 				allowedScopes.insert(modName);
 		}
 
 		// normally ID's from all required mods, own mod and virtual built-in mod are allowed
-		else if(request.localScope != ModScope::scopeBuiltin() && !request.localScope.empty())
+		else if(localScope != ModScope::scopeBuiltin() && !localScope.empty())
 		{
-			allowedScopes = VLC->modh->getModDependencies(request.localScope, isValidScope);
+			allowedScopes = VLC->modh->getModDependencies(localScope, isValidScope);
 
 			if(!isValidScope)
-				return std::vector<ObjectData>();
+			{
+				allowedScopes.clear();
+				return allowedScopes;
+			}
 
-			allowedScopes.insert(request.localScope);
+			allowedScopes.insert(localScope);
 		}
 
 		// all mods can access built-in mod
@@ -380,34 +403,38 @@ std::vector<CIdentifierStorage::ObjectData> CIdentifierStorage::getPossibleIdent
 	else
 	{
 		//if destination mod was specified explicitly, restrict lookup to this mod
-		if(request.remoteScope == ModScope::scopeBuiltin() )
+		if(remoteScope == ModScope::scopeBuiltin() )
 		{
 			//built-in mod is an implicit dependency for all mods, allow access into it
-			allowedScopes.insert(request.remoteScope);
+			allowedScopes.insert(remoteScope);
 		}
-		else if ( request.localScope == ModScope::scopeGame() )
+		else if ( localScope == ModScope::scopeGame() )
 		{
 			// allow access, this is special scope that should have access to all in-game objects
-			allowedScopes.insert(request.remoteScope);
+			allowedScopes.insert(remoteScope);
 		}
-		else if(request.remoteScope == request.localScope )
+		else if(remoteScope == localScope )
 		{
 			// allow self-access
-			allowedScopes.insert(request.remoteScope);
+			allowedScopes.insert(remoteScope);
 		}
 		else
 		{
 			// allow access only if mod is in our dependencies
-			auto myDeps = VLC->modh->getModDependencies(request.localScope, isValidScope);
+			auto myDeps = VLC->modh->getModDependencies(localScope, isValidScope);
 
-			if(!isValidScope)
-				return std::vector<ObjectData>();
-
-			if(myDeps.count(request.remoteScope))
-				allowedScopes.insert(request.remoteScope);
+			if(isValidScope && myDeps.count(remoteScope))
+				allowedScopes.insert(remoteScope);
 		}
 	}
 
+	return allowedScopes;
+}
+
+std::vector<CIdentifierStorage::ObjectData> CIdentifierStorage::getPossibleIdentifiers(const ObjectCallback & request) const
+{
+	const auto & allowedScopes = getAllowedScopes(request.localScope, request.remoteScope);
+
 	std::string fullID = request.type + '.' + request.name;
 
 	auto entries = registeredObjects.equal_range(fullID);
@@ -432,16 +459,19 @@ bool CIdentifierStorage::resolveIdentifier(const ObjectCallback & request) const
 	auto identifiers = getPossibleIdentifiers(request);
 	if (identifiers.size() == 1) // normally resolved ID
 	{
+		requestsResolved++;
 		request.callback(identifiers.front().id);
 		return true;
 	}
 
 	if (request.optional && identifiers.empty()) // failed to resolve optional ID
 	{
+		requestsResolved++;
 		return true;
 	}
 
 	// error found. Try to generate some debug info
+	requestsFailed++;
 	showIdentifierResolutionErrorDetails(request);
 	return false;
 }
@@ -452,19 +482,31 @@ void CIdentifierStorage::finalize()
 
 	state = ELoadingState::FINALIZING;
 
+	auto started = std::chrono::steady_clock::now();
+
 	while ( !scheduledRequests.empty() )
 	{
 		// Use local copy since new requests may appear during resolving, invalidating any iterators
-		auto request = scheduledRequests.back();
+		auto request = std::move(scheduledRequests.back());
 		scheduledRequests.pop_back();
 		resolveIdentifier(request);
 	}
 
+	finalizationMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
 	state = ELoadingState::FINISHED;
+
+	debugDumpIdentifiers();
 }
 
 void CIdentifierStorage::debugDumpIdentifiers()
 {
+	logMod->debug("Identifiers: %d registered, %d requests scheduled, %d resolved, %d failed, %d immediate lookups, %d scope sets",
+		registeredObjects.size(), requestsScheduled.load(), requestsResolved.load(), requestsFailed.load(), immediateLookups.load(), allowedScopesCache.size());
+	logMod->debug("Resolution of scheduled identifiers took %d ms", static_cast<int>(finalizationMilliseconds));
+
+	if (!logMod->isTraceEnabled())
+		return;
+
 	logMod->trace("List of all registered objects:");
 
 	std::map<std::string, std::vector<std::string>> objectList;
@@ -55,14 +55,30 @@ class DLL_LINKAGE CIdentifierStorage
 		}
 	};
 
-	std::multimap<std::string, ObjectData> registeredObjects;
+	/// All registered objects, indexed by full ID in form <type>.<name>
+	std::unordered_multimap<std::string, ObjectData> registeredObjects;
 	mutable std::vector<ObjectCallback> scheduledRequests;
 
+	/// Scopes that can be accessed by request with specific local and remote scopes
+	/// Mod dependencies do not change once loading has started, so this can be computed once for each pair
+	/// Immediate lookups may be done by several threads at once, so cache is guarded by mutex. Entries are never removed
+	mutable std::map<std::pair<std::string, std::string>, std::set<std::string>> allowedScopesCache;
+	mutable boost::shared_mutex allowedScopesMutex;
+
+	/// Statistics of identifier resolution
+	mutable std::atomic<size_t> requestsScheduled = 0;
+	mutable std::atomic<size_t> requestsResolved = 0;
+	mutable std::atomic<size_t> requestsFailed = 0;
+	mutable std::atomic<size_t> immediateLookups = 0;
+	double finalizationMilliseconds = 0;
+
 	ELoadingState state = ELoadingState::LOADING;
 
-	/// Helper method that dumps all registered identifier into log file
+	/// Helper method that dumps statistics and all registered identifier into log file
 	void debugDumpIdentifiers();
 
+	const std::set<std::string> & getAllowedScopes(const std::string & localScope, const std::string & remoteScope) const;
+
 	/// Check if identifier can be valid (camelCase, point as separator)
 	static void checkIdentifier(std::string & ID);
 
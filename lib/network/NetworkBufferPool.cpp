@@ -0,0 +1,48 @@
+/*
+ * NetworkBufferPool.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "NetworkBufferPool.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+std::shared_ptr<std::vector<std::byte>> NetworkBufferPool::acquire(size_t size)
+{
+	std::shared_ptr<std::vector<std::byte>> result;
+
+	{
+		std::lock_guard lock(mutex);
+		if (!freeBuffers.empty())
+		{
+			result = std::move(freeBuffers.back());
+			freeBuffers.pop_back();
+		}
+	}
+
+	if (!result)
+		result = std::make_shared<std::vector<std::byte>>();
+
+	result->resize(size);
+	return result;
+}
+
+void NetworkBufferPool::release(NetworkPacketPtr && buffer)
+{
+	if (!buffer || buffer.use_count() != 1)
+		return;
+
+	if (buffer->capacity() > maxPooledBufferCapacity)
+		return;
+
+	std::lock_guard lock(mutex);
+	if (freeBuffers.size() < maxPooledBuffers)
+		freeBuffers.push_back(std::const_pointer_cast<std::vector<std::byte>>(std::move(buffer)));
+}
+
+VCMI_LIB_NAMESPACE_END
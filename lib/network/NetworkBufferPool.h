@@ -0,0 +1,35 @@
+/*
+ * NetworkBufferPool.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "NetworkInterface.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Pool of reusable message buffers, so relayed messages don't need memory allocation once pool is warmed up
+/// Thread-safe, buffers may be acquired on one thread and released on another
+class NetworkBufferPool : boost::noncopyable
+{
+	static constexpr size_t maxPooledBuffers = 64;
+	/// Buffers of rare large messages are freed instead of keeping them in pool for lifetime of connection
+	static constexpr size_t maxPooledBufferCapacity = 256 * 1024;
+
+	std::mutex mutex;
+	std::vector<std::shared_ptr<std::vector<std::byte>>> freeBuffers;
+
+public:
+	/// Returns buffer of specified size, reusing previously released buffer if possible
+	std::shared_ptr<std::vector<std::byte>> acquire(size_t size);
+
+	/// Returns buffer to pool. Buffer must not be referenced anywhere else
+	void release(NetworkPacketPtr && buffer);
+};
+
+VCMI_LIB_NAMESPACE_END
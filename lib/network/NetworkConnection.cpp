@@ -10,11 +10,16 @@
 #include "StdInc.h"
 #include "NetworkConnection.h"
 
+#include "NetworkBufferPool.h"
+
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 NetworkConnection::NetworkConnection(INetworkConnectionListener & listener, const std::shared_ptr<NetworkSocket> & socket, const std::shared_ptr<NetworkContext> & context)
 	: socket(socket)
 	, timer(std::make_shared<NetworkTimer>(*context))
+	, strand(boost::asio::make_strand(*context))
 	, listener(listener)
 {
 	socket->set_option(boost::asio::ip::tcp::no_delay(true));
@@ -41,6 +46,18 @@ NetworkConnection::NetworkConnection(INetworkConnectionListener & listener, cons
 	}
 }
 
+NetworkConnection::~NetworkConnection()
+{
+	const auto & stats = compressionStatistics;
+
+	if (stats.messagesCompressed != 0 || stats.messagesDecompressed != 0)
+	{
+		logNetwork->debug("Connection compression: %d messages compressed %d -> %d bytes in %d us, %d messages decompressed %d -> %d bytes in %d us",
+			stats.messagesCompressed.load(), stats.bytesBeforeCompression.load(), stats.bytesAfterCompression.load(), stats.compressionTime.load(),
+			stats.messagesDecompressed, stats.bytesBeforeDecompression, stats.bytesAfterDecompression, stats.decompressionTime);
+	}
+}
+
 void NetworkConnection::start()
 {
 	heartbeat();
@@ -52,7 +69,7 @@ void NetworkConnection::startReceiving()
 	boost::asio::async_read(*socket,
 							readBuffer,
 							boost::asio::transfer_exactly(messageHeaderSize),
-							[self = shared_from_this()](const auto & ec, const auto & endpoint) { self->onHeaderReceived(ec); });
+							boost::asio::bind_executor(strand, [self = shared_from_this()](const auto & ec, const auto & endpoint) { self->onHeaderReceived(ec); }));
 }
 
 void NetworkConnection::heartbeat()
@@ -60,7 +77,7 @@ void NetworkConnection::heartbeat()
 	constexpr auto heartbeatInterval = std::chrono::seconds(10);
 
 	timer->expires_after(heartbeatInterval);
-	timer->async_wait( [self = weak_from_this()](const auto & ec)
+	timer->async_wait(boost::asio::bind_executor(strand, [self = weak_from_this()](const auto & ec)
 	{
 		if (ec)
 			return;
@@ -69,9 +86,9 @@ void NetworkConnection::heartbeat()
 		if (!locked)
 			return;
 
-		locked->sendPacket({});
+		locked->sendPacket(NetworkPacketPtr());
 		locked->heartbeat();
-	});
+	}));
 }
 
 void NetworkConnection::onHeaderReceived(const boost::system::error_code & ecHeader)
@@ -88,6 +105,10 @@ void NetworkConnection::onHeaderReceived(const boost::system::error_code & ecHea
 	uint32_t messageSize;
 	readBuffer.sgetn(reinterpret_cast<char *>(&messageSize), sizeof(messageSize));
 
+	uint32_t header = messageSize;
+	bool compressed = messageSize & compressedMessageFlag;
+	messageSize &= ~compressedMessageFlag;
+
 	if (messageSize > messageMaxSize)
 	{
 		onError("Invalid packet size!");
@@ -101,13 +122,23 @@ void NetworkConnection::onHeaderReceived(const boost::system::error_code & ecHea
 		return;
 	}
 
+	if (relayTarget)
+	{
+		// relayed messages are read directly into pooled buffer that is then queued to target as is
+		auto payload = relayBuffers->acquire(messageSize);
+		boost::asio::async_read(*socket,
+								boost::asio::buffer(*payload),
+								boost::asio::bind_executor(strand, [self = shared_from_this(), header, payload](const auto & ecPayload, const auto & endpoint) { self->onRelayedPacketReceived(ecPayload, header, payload); }));
+		return;
+	}
+
 	boost::asio::async_read(*socket,
 							readBuffer,
 							boost::asio::transfer_exactly(messageSize),
-							[self = shared_from_this(), messageSize](const auto & ecPayload, const auto & endpoint) { self->onPacketReceived(ecPayload, messageSize); });
+							boost::asio::bind_executor(strand, [self = shared_from_this(), messageSize, compressed](const auto & ecPayload, const auto & endpoint) { self->onPacketReceived(ecPayload, messageSize, compressed); }));
 }
 
-void NetworkConnection::onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize)
+void NetworkConnection::onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize, bool compressed)
 {
 	if (ec)
 	{
@@ -124,68 +155,278 @@ void NetworkConnection::onPacketReceived(const boost::system::error_code & ec, u
 
 	std::vector<std::byte> message(expectedPacketSize);
 	readBuffer.sgetn(reinterpret_cast<char *>(message.data()), expectedPacketSize);
-	listener.onPacketReceived(shared_from_this(), message);
+
+	if (compressed)
+	{
+		if (!decompress(message))
+		{
+			onError("Failed to decompress packet!");
+			return;
+		}
+		listener.onPacketReceived(shared_from_this(), decompressionBuffer);
+	}
+	else
+		listener.onPacketReceived(shared_from_this(), message);
+
+	startReceiving();
+}
+
+void NetworkConnection::onRelayedPacketReceived(const boost::system::error_code & ec, uint32_t header, const std::shared_ptr<std::vector<std::byte>> & payload)
+{
+	if (ec)
+	{
+		onError(ec.message());
+		return;
+	}
+
+	// relay target is reset on closing, on the same strand
+	if (!relayTarget)
+		return;
+
+	relayedMessages += 1;
+	relayedBytes += payload->size();
+	relayTarget->sendRelayedPacket(header, payload, relayBuffers);
 
 	startReceiving();
 }
 
+NetworkPacketPtr NetworkConnection::compress(const NetworkPacketPtr & message) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// compressed payload: uncompressed size followed by zlib stream
+	uLongf compressedSize = compressBound(message->size());
+	auto result = std::make_shared<std::vector<std::byte>>(sizeof(uint32_t) + compressedSize);
+
+	uint32_t originalSize = message->size();
+	std::memcpy(result->data(), &originalSize, sizeof(uint32_t));
+
+	int status = compress2(
+		reinterpret_cast<Bytef *>(result->data() + sizeof(uint32_t)),
+		&compressedSize,
+		reinterpret_cast<const Bytef *>(message->data()),
+		message->size(),
+		Z_BEST_SPEED);
+
+	if (status != Z_OK || sizeof(uint32_t) + compressedSize >= message->size())
+		return message; // incompressible data, send as is
+
+	result->resize(sizeof(uint32_t) + compressedSize);
+
+	compressionStatistics.messagesCompressed++;
+	compressionStatistics.bytesBeforeCompression += message->size();
+	compressionStatistics.bytesAfterCompression += result->size();
+	compressionStatistics.compressionTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	return result;
+}
+
+bool NetworkConnection::decompress(const std::vector<std::byte> & message)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	if (message.size() < sizeof(uint32_t))
+		return false;
+
+	uint32_t originalSize;
+	std::memcpy(&originalSize, message.data(), sizeof(uint32_t));
+
+	if (originalSize > messageMaxSize)
+		return false;
+
+	// buffer is reused between messages, so capacity is only allocated once for largest message
+	decompressionBuffer.resize(originalSize);
+
+	uLongf decompressedSize = originalSize;
+	int status = uncompress(
+		reinterpret_cast<Bytef *>(decompressionBuffer.data()),
+		&decompressedSize,
+		reinterpret_cast<const Bytef *>(message.data() + sizeof(uint32_t)),
+		message.size() - sizeof(uint32_t));
+
+	if (status != Z_OK || decompressedSize != originalSize)
+		return false;
+
+	compressionStatistics.messagesDecompressed++;
+	compressionStatistics.bytesBeforeDecompression += message.size();
+	compressionStatistics.bytesAfterDecompression += originalSize;
+	compressionStatistics.decompressionTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	return true;
+}
+
 void NetworkConnection::setAsyncWritesEnabled(bool on)
 {
 	asyncWritesEnabled = on;
 }
 
+void NetworkConnection::setCompressionThreshold(uint32_t threshold)
+{
+	boost::system::error_code ec;
+	auto endpoint = socket->remote_endpoint(ec);
+
+	// compression only wastes CPU time if both sides are on the same machine
+	if (threshold != 0 && !ec && endpoint.address().is_loopback())
+	{
+		logNetwork->debug("Compression is not used for local connection");
+		return;
+	}
+
+	compressionThreshold = threshold;
+}
+
+void NetworkConnection::setRelayTarget(const std::shared_ptr<INetworkConnection> & target)
+{
+	auto targetConnection = std::dynamic_pointer_cast<NetworkConnection>(target);
+	if (!targetConnection)
+		throw std::runtime_error("Relay target must be a network connection!");
+
+	// switch on strand, so messages that are already being processed are delivered to listener before relaying starts
+	boost::asio::post(strand, [self = shared_from_this(), targetConnection]()
+	{
+		self->relayBuffers = std::make_shared<NetworkBufferPool>();
+		self->relayTarget = targetConnection;
+	});
+}
+
+NetworkRelayStatistics NetworkConnection::getRelayStatistics() const
+{
+	NetworkRelayStatistics result;
+	result.messages = relayedMessages;
+	result.bytes = relayedBytes;
+	return result;
+}
+
 void NetworkConnection::sendPacket(const std::vector<std::byte> & message)
+{
+	if (message.empty())
+		sendPacket(NetworkPacketPtr());
+	else
+		sendPacket(std::make_shared<const std::vector<std::byte>>(message));
+}
+
+void NetworkConnection::sendPacket(const NetworkPacketPtr & message)
+{
+	// compression is done before locking, so other senders on this connection are not blocked by it
+	sendMessage(prepareMessage(message));
+}
+
+NetworkMessage NetworkConnection::prepareMessage(const NetworkPacketPtr & message) const
+{
+	NetworkMessage result;
+	uint32_t threshold = compressionThreshold;
+
+	if (message && !message->empty())
+		result.payload = message;
+
+	if (threshold != 0 && result.payload && result.payload->size() > threshold)
+	{
+		result.payload = compress(message);
+		result.compressed = result.payload != message;
+	}
+
+	return result;
+}
+
+void NetworkConnection::sendMessage(const NetworkMessage & message)
 {
 	std::lock_guard lock(writeMutex);
-	std::vector<std::byte> headerVector(sizeof(uint32_t));
-	uint32_t messageSize = message.size();
-	std::memcpy(headerVector.data(), &messageSize, sizeof(uint32_t));
 
+	OutgoingPacket packet;
+	uint32_t messageSize = message.payload ? message.payload->size() : 0;
+
+	if (message.compressed)
+		messageSize |= compressedMessageFlag;
+
+	packet.payload = message.payload;
+	std::memcpy(packet.header.data(), &messageSize, sizeof(uint32_t));
+	queuePacket(std::move(packet));
+}
+
+uint32_t NetworkConnection::getCompressionThreshold() const
+{
+	return compressionThreshold;
+}
+
+void NetworkConnection::sendRelayedPacket(uint32_t header, const std::shared_ptr<std::vector<std::byte>> & payload, const std::shared_ptr<NetworkBufferPool> & pool)
+{
+	std::lock_guard lock(writeMutex);
+
+	OutgoingPacket packet;
+	std::memcpy(packet.header.data(), &header, sizeof(uint32_t));
+	packet.payload = payload;
+	packet.pool = pool;
+	queuePacket(std::move(packet));
+}
+
+void NetworkConnection::queuePacket(OutgoingPacket && packet)
+{
 	// At the moment, vcmilobby *requires* async writes in order to handle multiple connections with different speeds and at optimal performance
 	// However server (and potentially - client) can not handle this mode and may shutdown either socket or entire asio service too early, before all writes are performed
 	if (asyncWritesEnabled)
 	{
-
 		bool messageQueueEmpty = dataToSend.empty();
-		dataToSend.push_back(headerVector);
-		if (!message.empty())
-			dataToSend.push_back(message);
+		dataToSend.push_back(std::move(packet));
 
+		// packet may be sent from any thread, but socket must only be accessed from the strand of this connection
 		if (messageQueueEmpty)
-			doSendData();
+			boost::asio::post(strand, [self = shared_from_this()](){ self->doSendData(); });
 		//else - data sending loop is still active and still sending previous messages
 	}
 	else
 	{
 		boost::system::error_code ec;
-		boost::asio::write(*socket, boost::asio::buffer(headerVector), ec );
-		if (!message.empty())
-			boost::asio::write(*socket, boost::asio::buffer(message), ec );
+		boost::asio::write(*socket, boost::asio::buffer(packet.header), ec );
+		if (packet.payload)
+			boost::asio::write(*socket, boost::asio::buffer(*packet.payload), ec );
+		if (packet.pool)
+			packet.pool->release(std::move(packet.payload));
 	}
 }
 
 void NetworkConnection::doSendData()
 {
+	std::lock_guard lock(writeMutex);
+
 	if (dataToSend.empty())
 		throw std::runtime_error("Attempting to sent data but there is no data to send!");
 
-	boost::asio::async_write(*socket, boost::asio::buffer(dataToSend.front()), [self = shared_from_this()](const auto & error, const auto & )
+	// references to deque elements are not invalidated by push_back, so front remains valid until it is popped in onDataSent
+	const auto & packet = dataToSend.front();
+
+	// header and payload are sent by a single write, payload is shared with other connections and is never copied
+	std::array<boost::asio::const_buffer, 2> buffers = {
+		boost::asio::buffer(packet.header),
+		packet.payload ? boost::asio::buffer(*packet.payload) : boost::asio::const_buffer()
+	};
+
+	boost::asio::async_write(*socket, buffers, boost::asio::bind_executor(strand, [self = shared_from_this()](const auto & error, const auto & )
 	{
 		self->onDataSent(error);
-	});
+	}));
 }
 
 void NetworkConnection::onDataSent(const boost::system::error_code & ec)
 {
-	std::lock_guard lock(writeMutex);
-	dataToSend.pop_front();
+	bool messageQueueEmpty;
+	OutgoingPacket sentPacket;
+	{
+		std::lock_guard lock(writeMutex);
+		sentPacket = std::move(dataToSend.front());
+		dataToSend.pop_front();
+		messageQueueEmpty = dataToSend.empty();
+	}
+
+	if (sentPacket.pool)
+		sentPacket.pool->release(std::move(sentPacket.payload));
+
 	if (ec)
 	{
 		onError(ec.message());
 		return;
 	}
 
-	if (!dataToSend.empty())
+	if (!messageQueueEmpty)
 		doSendData();
 }
 
@@ -197,10 +438,19 @@ void NetworkConnection::onError(const std::string & message)
 
 void NetworkConnection::close()
 {
+	if (asyncWritesEnabled && !strand.running_in_this_thread())
+	{
+		boost::asio::post(strand, [self = shared_from_this()](){ self->close(); });
+		return;
+	}
+
 	boost::system::error_code ec;
 	socket->close(ec);
 	timer->cancel(ec);
 
+	// breaks reference cycle between two relayed connections
+	relayTarget.reset();
+
 	//NOTE: ignoring error code, intended
 }
 
@@ -13,37 +13,89 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+class NetworkBufferPool;
+
 class NetworkConnection final : public INetworkConnection, public std::enable_shared_from_this<NetworkConnection>
 {
 	static const int messageHeaderSize = sizeof(uint32_t);
 	static const int messageMaxSize = 64 * 1024 * 1024; // arbitrary size to prevent potential massive allocation if we receive garbage input
+	static const uint32_t compressedMessageFlag = 0x80000000; // set in header of compressed messages, never set in valid size
+
+	struct CompressionStatistics
+	{
+		// messages may be compressed by any thread
+		std::atomic<uint64_t> messagesCompressed = 0;
+		std::atomic<uint64_t> bytesBeforeCompression = 0;
+		std::atomic<uint64_t> bytesAfterCompression = 0;
+		std::atomic<uint64_t> compressionTime = 0; // in microseconds
+		uint64_t messagesDecompressed = 0;
+		uint64_t bytesBeforeDecompression = 0;
+		uint64_t bytesAfterDecompression = 0;
+		uint64_t decompressionTime = 0; // in microseconds
+	};
 
-	std::list<std::vector<std::byte>> dataToSend;
+	struct OutgoingPacket
+	{
+		std::array<std::byte, messageHeaderSize> header;
+		NetworkPacketPtr payload;
+		std::shared_ptr<NetworkBufferPool> pool; // if set, payload is returned to this pool once sent
+	};
+
+	std::deque<OutgoingPacket> dataToSend;
 	std::shared_ptr<NetworkSocket> socket;
 	std::shared_ptr<NetworkTimer> timer;
+	/// serializes all handlers of this connection, so context may be run by multiple threads
+	NetworkStrand strand;
 	std::mutex writeMutex;
 
 	NetworkBuffer readBuffer;
 	INetworkConnectionListener & listener;
 	bool asyncWritesEnabled = false;
 
+	std::atomic<uint32_t> compressionThreshold = 0;
+	std::vector<std::byte> decompressionBuffer;
+	mutable CompressionStatistics compressionStatistics;
+
+	/// in relay mode, received messages are forwarded to this connection without processing
+	std::shared_ptr<NetworkConnection> relayTarget;
+	std::shared_ptr<NetworkBufferPool> relayBuffers;
+	std::atomic<uint64_t> relayedMessages = 0;
+	std::atomic<uint64_t> relayedBytes = 0;
+
 	void heartbeat();
 	void onError(const std::string & message);
 
 	void startReceiving();
 	void onHeaderReceived(const boost::system::error_code & ec);
-	void onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize);
+	void onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize, bool compressed);
+	void onRelayedPacketReceived(const boost::system::error_code & ec, uint32_t header, const std::shared_ptr<std::vector<std::byte>> & payload);
+
+	NetworkPacketPtr compress(const NetworkPacketPtr & message) const;
+	bool decompress(const std::vector<std::byte> & message);
+
+	/// Queues packet for sending, writeMutex must be locked by caller
+	void queuePacket(OutgoingPacket && packet);
+	/// Queues message received by relay source, with header kept as is
+	void sendRelayedPacket(uint32_t header, const std::shared_ptr<std::vector<std::byte>> & payload, const std::shared_ptr<NetworkBufferPool> & pool);
 
 	void doSendData();
 	void onDataSent(const boost::system::error_code & ec);
 
 public:
 	NetworkConnection(INetworkConnectionListener & listener, const std::shared_ptr<NetworkSocket> & socket, const std::shared_ptr<NetworkContext> & context);
+	~NetworkConnection();
 
 	void start();
 	void close() override;
 	void sendPacket(const std::vector<std::byte> & message) override;
+	void sendPacket(const NetworkPacketPtr & message) override;
+	NetworkMessage prepareMessage(const NetworkPacketPtr & message) const override;
+	void sendMessage(const NetworkMessage & message) override;
+	uint32_t getCompressionThreshold() const override;
 	void setAsyncWritesEnabled(bool on) override;
+	void setCompressionThreshold(uint32_t threshold) override;
+	void setRelayTarget(const std::shared_ptr<INetworkConnection> & target) override;
+	NetworkRelayStatistics getRelayStatistics() const override;
 };
 
 VCMI_LIB_NAMESPACE_END
@@ -20,5 +20,6 @@ using NetworkSocket = boost::asio::ip::tcp::socket;
 using NetworkAcceptor = boost::asio::ip::tcp::acceptor;
 using NetworkBuffer = boost::asio::streambuf;
 using NetworkTimer = boost::asio::steady_timer;
+using NetworkStrand = boost::asio::strand<NetworkContext::executor_type>;
 
 VCMI_LIB_NAMESPACE_END
@@ -51,9 +51,10 @@ void NetworkHandler::connectToRemote(INetworkClientListener & listener, const st
 				return;
 			}
 			auto connection = std::make_shared<NetworkConnection>(listener, socket, io);
-			connection->start();
 
+			// listener must configure connection before any of its handlers can run on another thread
 			listener.onConnectionEstablished(connection);
+			connection->start();
 		});
 	});
 }
@@ -11,13 +11,44 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Immutable, already encoded packet that can be queued to multiple connections without copying
+using NetworkPacketPtr = std::shared_ptr<const std::vector<std::byte>>;
+
+/// Packet prepared for sending, with payload compressed if needed
+/// Can be sent by every connection with same compression threshold, so shared packet is compressed only once
+struct NetworkMessage
+{
+	NetworkPacketPtr payload;
+	bool compressed = false;
+};
+
+/// Amount of data forwarded by connection in relay mode
+struct NetworkRelayStatistics
+{
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+};
+
 /// Base class for connections with other services, either incoming or outgoing
 class DLL_LINKAGE INetworkConnection : boost::noncopyable
 {
 public:
 	virtual ~INetworkConnection() = default;
 	virtual void sendPacket(const std::vector<std::byte> & message) = 0;
+	virtual void sendPacket(const NetworkPacketPtr & message) = 0;
+	/// Compresses packet if its size is above compression threshold. May be called from any thread, does not block senders
+	virtual NetworkMessage prepareMessage(const NetworkPacketPtr & message) const = 0;
+	/// Sends message prepared by connection with same compression threshold
+	virtual void sendMessage(const NetworkMessage & message) = 0;
+	virtual uint32_t getCompressionThreshold() const = 0;
 	virtual void setAsyncWritesEnabled(bool on) = 0;
+	/// Messages with size above threshold are compressed before sending, 0 disables compression
+	/// Compressed messages are always accepted, so this must only be enabled once remote side is known to support it
+	virtual void setCompressionThreshold(uint32_t threshold) = 0;
+	/// Switches connection into relay mode: every following message is forwarded to target as is,
+	/// without decompression and without notifying listener. Relay mode ends when connection is closed
+	virtual void setRelayTarget(const std::shared_ptr<INetworkConnection> & target) = 0;
+	virtual NetworkRelayStatistics getRelayStatistics() const = 0;
 	virtual void close() = 0;
 };
 
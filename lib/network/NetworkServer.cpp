@@ -41,20 +41,26 @@ void NetworkServer::connectionAccepted(std::shared_ptr<NetworkSocket> upcomingCo
 
 	logNetwork->info("We got a new connection! :)");
 	auto connection = std::make_shared<NetworkConnection>(*this, upcomingConnection, io);
-	connections.insert(connection);
-	connection->start();
+	{
+		std::lock_guard lock(connectionsMutex);
+		connections.insert(connection);
+	}
+	// listener must configure connection before any of its handlers can run on another thread
 	listener.onNewConnection(connection);
+	connection->start();
 	startAsyncAccept();
 }
 
 void NetworkServer::onDisconnected(const std::shared_ptr<INetworkConnection> & connection, const std::string & errorMessage)
 {
 	logNetwork->info("Connection lost! Reason: %s", errorMessage);
-	if (connections.count(connection))
 	{
-		connections.erase(connection);
-		listener.onDisconnected(connection, errorMessage);
+		std::lock_guard lock(connectionsMutex);
+		if (connections.erase(connection) == 0)
+			return;
 	}
+
+	listener.onDisconnected(connection, errorMessage);
 }
 
 void NetworkServer::onPacketReceived(const std::shared_ptr<INetworkConnection> & connection, const std::vector<std::byte> & message)
@@ -18,6 +18,8 @@ class NetworkServer : public INetworkConnectionListener, public INetworkServer
 	std::shared_ptr<NetworkContext> io;
 	std::shared_ptr<NetworkAcceptor> acceptor;
 	std::set<std::shared_ptr<INetworkConnection>> connections;
+	/// protects set of connections, since handlers of different connections may run on different threads
+	std::mutex connectionsMutex;
 
 	INetworkServerListener & listener;
 
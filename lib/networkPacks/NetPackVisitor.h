@@ -28,6 +28,7 @@ public:
 	virtual void visitForClient(CPackForClient & pack) {}
 	virtual void visitPackageApplied(PackageApplied & pack) {}
 	virtual void visitSystemMessage(SystemMessage & pack) {}
+	virtual void visitPackBatch(PackBatch & pack) {}
 	virtual void visitPlayerBlocked(PlayerBlocked & pack) {}
 	virtual void visitPlayerCheated(PlayerCheated & pack) {}
 	virtual void visitPlayerStartsTurn(PlayerStartsTurn & pack) {}
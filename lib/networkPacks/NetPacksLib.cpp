@@ -44,6 +44,7 @@
 #include "mapObjectConstructors/AObjectTypeHandler.h"
 #include "mapObjectConstructors/CObjectClassesHandler.h"
 #include "campaign/CampaignState.h"
+#include "IGameCallback.h"
 #include "GameSettings.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -102,6 +103,11 @@ void SystemMessage::visitTyped(ICPackVisitor & visitor)
 	visitor.visitSystemMessage(*this);
 }
 
+void PackBatch::visitTyped(ICPackVisitor & visitor)
+{
+	visitor.visitPackBatch(*this);
+}
+
 void PlayerBlocked::visitTyped(ICPackVisitor & visitor)
 {
 	visitor.visitPlayerBlocked(*this);
@@ -956,12 +962,93 @@ void SetMovePoints::applyGs(CGameState *gs)
 		hero->setMovementPoints(hero->movementPointsRemaining() + val);
 }
 
+std::vector<FoWChange::TileSpan> FoWChange::makeSpans(const std::unordered_set<int3> & tiles)
+{
+	std::vector<int3> sortedTiles(tiles.begin(), tiles.end());
+
+	// same order as in fog of war map - [z][x][y]
+	std::sort(sortedTiles.begin(), sortedTiles.end(), [](const int3 & a, const int3 & b)
+	{
+		return std::tie(a.z, a.x, a.y) < std::tie(b.z, b.x, b.y);
+	});
+
+	std::vector<TileSpan> result;
+
+	for(const int3 & tile : sortedTiles)
+	{
+		if(!result.empty())
+		{
+			auto & last = result.back();
+
+			if(last.start.z == tile.z && last.start.x == tile.x && last.start.y + last.length == tile.y)
+			{
+				last.length++;
+				continue;
+			}
+		}
+
+		result.push_back({tile, 1});
+	}
+
+	return result;
+}
+
+void FoWChange::checkSpans(const std::vector<TileSpan> & spans, const int3 & mapSize)
+{
+	for(const auto & span : spans)
+	{
+		bool startValid = span.start.x >= 0 && span.start.x < mapSize.x
+			&& span.start.y >= 0 && span.start.y < mapSize.y
+			&& span.start.z >= 0 && span.start.z < mapSize.z;
+
+		if(!startValid || span.length <= 0 || static_cast<int64_t>(span.start.y) + span.length > mapSize.y)
+			throw std::runtime_error("Fog of war change contains tiles outside of map: " + span.start.toString() + " + " + std::to_string(span.length));
+	}
+}
+
+void FoWChange::checkLoadedSpans(const IGameCallback * cb) const
+{
+	if(cb)
+		checkSpans(loadedSpans, cb->getMapSize());
+}
+
+std::unordered_set<int3> FoWChange::getTiles() const
+{
+	if(loadedSpans.empty())
+		return tiles;
+
+	size_t tilesCount = 0;
+	for(const auto & span : loadedSpans)
+		tilesCount += span.length;
+
+	std::unordered_set<int3> result;
+	result.reserve(tilesCount);
+	for(const auto & span : loadedSpans)
+		for(int32_t i = 0; i < span.length; ++i)
+			result.insert(int3(span.start.x, span.start.y + i, span.start.z));
+
+	return result;
+}
+
 void FoWChange::applyGs(CGameState *gs)
 {
 	TeamState * team = gs->getPlayerTeam(player);
 	auto & fogOfWarMap = team->fogOfWarMap;
-	for(const int3 & t : tiles)
-		fogOfWarMap[t.z][t.x][t.y] = mode != ETileVisibility::HIDDEN;
+	ui8 newValue = mode != ETileVisibility::HIDDEN;
+
+	std::vector<TileSpan> computedSpans;
+	if(loadedSpans.empty())
+		computedSpans = makeSpans(tiles);
+
+	const auto & spans = loadedSpans.empty() ? computedSpans : loadedSpans;
+
+	checkSpans(spans, gs->getMapSize());
+
+	for(const auto & span : spans)
+	{
+		auto * column = &fogOfWarMap[span.start.z][span.start.x][span.start.y];
+		std::fill(column, column + span.length, newValue);
+	}
 
 	if (mode == ETileVisibility::HIDDEN) //do not hide too much
 	{
@@ -42,6 +42,7 @@ struct StackLocation;
 struct ArtSlotInfo;
 struct QuestInfo;
 class IBattleState;
+class IGameCallback;
 class BattleInfo;
 
 // This one teleport-specific, but has to be available everywhere in callbacks and netpacks
@@ -73,6 +74,38 @@ struct DLL_LINKAGE PackageApplied : public CPackForClient
 	}
 };
 
+/// Packs generated by single server action, delivered as single network message and applied in same order as on server
+/// Packs are stored already encoded since they must be encoded before they are applied on server
+struct DLL_LINKAGE PackBatch : public CPackForClient
+{
+	void visitTyped(ICPackVisitor & visitor) override;
+	void applyGs(CGameState *gs) override {}
+
+	/// Sizes of encoded packs, in order in which they must be applied
+	std::vector<uint32_t> packSizes;
+	/// Packs to send, already encoded for target connection. Only used when saving
+	std::vector<std::shared_ptr<const std::vector<std::byte>>> encodedPacks;
+	/// Received packs, stored one after another. Only used when loading
+	std::vector<std::byte> packsData;
+
+	template <typename Handler> void serialize(Handler & h)
+	{
+		h & packSizes;
+
+		// packs are written as raw bytes, without per-byte serialization or intermediate copies
+		if constexpr (Handler::saving)
+		{
+			for(const auto & pack : encodedPacks)
+				h.write(pack->data(), pack->size());
+		}
+		else
+		{
+			packsData.resize(std::accumulate(packSizes.begin(), packSizes.end(), static_cast<size_t>(0)));
+			h.read(packsData.data(), packsData.size(), false);
+		}
+	}
+};
+
 struct DLL_LINKAGE SystemMessage : public CPackForClient
 {
 	explicit SystemMessage(MetaString Text)
@@ -340,6 +373,19 @@ struct DLL_LINKAGE SetMovePoints : public CPackForClient
 
 struct DLL_LINKAGE FoWChange : public CPackForClient
 {
+	/// Run of tiles with consecutive y coordinate, such tiles are adjacent in fog of war map
+	struct TileSpan
+	{
+		int3 start;
+		int32_t length = 0;
+
+		template <typename Handler> void serialize(Handler & h)
+		{
+			h & start;
+			h & length;
+		}
+	};
+
 	void applyGs(CGameState * gs) override;
 
 	std::unordered_set<int3> tiles;
@@ -349,13 +395,47 @@ struct DLL_LINKAGE FoWChange : public CPackForClient
 
 	void visitTyped(ICPackVisitor & visitor) override;
 
+	static std::vector<TileSpan> makeSpans(const std::unordered_set<int3> & tiles);
+
+	/// Throws if any of spans is empty or does not fit into map of specified size
+	static void checkSpans(const std::vector<TileSpan> & spans, const int3 & mapSize);
+
+	/// Returns changed tiles. Received packs only keep spans, so the set is rebuilt on every call
+	std::unordered_set<int3> getTiles() const;
+
 	template <typename Handler> void serialize(Handler & h)
 	{
-		h & tiles;
+		if (h.version >= Handler::Version::FOG_OF_WAR_SPANS)
+		{
+			if (h.saving && !tiles.empty())
+			{
+				auto spans = makeSpans(tiles);
+				h & spans;
+			}
+			else
+			{
+				// pack that was loaded itself has no tiles, only spans
+				h & loadedSpans;
+			}
+
+			if constexpr (!Handler::saving)
+				checkLoadedSpans(h.cb);
+		}
+		else
+		{
+			h & tiles;
+		}
 		h & player;
 		h & mode;
 		h & waitForDialogs;
 	}
+
+private:
+	/// Spans received over network, allow updating fog of war map without building set of tiles
+	std::vector<TileSpan> loadedSpans;
+
+	/// Rejects received pack if its spans do not fit into map of current game, if any
+	void checkLoadedSpans(const IGameCallback * cb) const;
 };
 
 struct DLL_LINKAGE SetAvailableHero : public CPackForClient
@@ -462,6 +462,8 @@ public:
 			if (length < 0)
 			{
 				int32_t stringID = -length - 1; // -1, -2 ... -> 0, 1 ...
+				if (static_cast<size_t>(stringID) >= loadedStrings.size())
+					throw std::runtime_error("Reference to unknown string in serialized data!");
 				data = loadedStrings[stringID];
 			}
 			if (length == 0)
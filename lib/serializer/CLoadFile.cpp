@@ -9,6 +9,10 @@
  */
 #include "StdInc.h"
 #include "CLoadFile.h"
+#include "CSaveFile.h"
+
+#include <tbb/parallel_for.h>
+#include <zlib.h>
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -23,10 +27,109 @@ CLoadFile::~CLoadFile() = default;
 
 int CLoadFile::read(std::byte * data, unsigned size)
 {
-	sfile->read(reinterpret_cast<char *>(data), size);
+	if(chunks.empty())
+	{
+		sfile->read(reinterpret_cast<char *>(data), size);
+		return size;
+	}
+
+	unsigned copied = 0;
+	while(copied < size)
+	{
+		if(currentChunk == chunks.size())
+			THROW_FORMAT("Error: unexpected end of file (%s)!", fName);
+
+		auto & chunk = chunks[currentChunk];
+		if(!chunk.loaded)
+			loadChunks(currentChunk);
+
+		size_t toCopy = std::min<size_t>(size - copied, chunk.data.size() - chunkPosition);
+		std::copy_n(chunk.data.data() + chunkPosition, toCopy, data + copied);
+		copied += toCopy;
+		chunkPosition += toCopy;
+
+		if(chunkPosition == chunk.data.size())
+		{
+			// chunk has been read completely and is no longer needed
+			chunk.data = {};
+			currentChunk += 1;
+			chunkPosition = 0;
+		}
+	}
 	return size;
 }
 
+void CLoadFile::readChunksTable()
+{
+	auto readValue = [this]()
+	{
+		uint32_t value;
+		sfile->read(reinterpret_cast<char *>(&value), sizeof(value));
+		if(serializer.reverseEndianness)
+			std::reverse(reinterpret_cast<char *>(&value), reinterpret_cast<char *>(&value) + sizeof(value));
+		return value;
+	};
+
+	uint32_t chunksCount = readValue();
+
+	// validate sizes against actual file size before allocating anything, to reject corrupted or truncated files
+	auto tablePosition = sfile->tellg();
+	sfile->seekg(0, std::ios::end);
+	uint64_t remainingSize = sfile->tellg() - tablePosition;
+	sfile->seekg(tablePosition);
+
+	uint64_t tableSize = static_cast<uint64_t>(chunksCount) * 3 * sizeof(uint32_t);
+	if(tableSize > remainingSize)
+		THROW_FORMAT("Error: corrupted chunks table (%s)!", fName);
+
+	remainingSize -= tableSize;
+	chunks.resize(chunksCount);
+
+	for(auto & chunk : chunks)
+	{
+		chunk.section = readValue();
+		chunk.uncompressedSize = readValue();
+		chunk.compressedSize = readValue();
+
+		if(chunk.uncompressedSize == 0 || chunk.uncompressedSize > CSaveFile::maxChunkSize)
+			THROW_FORMAT("Error: corrupted chunks table (%s)!", fName);
+
+		if(chunk.compressedSize > remainingSize)
+			THROW_FORMAT("Error: unexpected end of file (%s)!", fName);
+
+		remainingSize -= chunk.compressedSize;
+	}
+}
+
+void CLoadFile::loadChunks(size_t firstChunk)
+{
+	// chunks of header are loaded one by one, so save preview does not need to decompress whole game state
+	size_t lastChunk = chunks[firstChunk].section == 0 ? firstChunk + 1 : chunks.size();
+
+	// chunks are stored sequentially and read in order, so file is already positioned at first chunk to load
+	std::vector<std::vector<std::byte>> compressed(lastChunk - firstChunk);
+	for(size_t i = firstChunk; i < lastChunk; ++i)
+	{
+		auto & chunkData = compressed[i - firstChunk];
+		chunkData.resize(chunks[i].compressedSize);
+		sfile->read(reinterpret_cast<char *>(chunkData.data()), chunkData.size());
+	}
+
+	tbb::parallel_for(firstChunk, lastChunk, [this, firstChunk, &compressed](size_t index)
+	{
+		auto & chunk = chunks[index];
+		auto & chunkData = compressed[index - firstChunk];
+		uLongf uncompressedSize = chunk.uncompressedSize;
+
+		chunk.data.resize(chunk.uncompressedSize);
+		int result = uncompress(reinterpret_cast<Bytef *>(chunk.data.data()), &uncompressedSize, reinterpret_cast<const Bytef *>(chunkData.data()), chunkData.size());
+		if(result != Z_OK || uncompressedSize != chunk.uncompressedSize)
+			THROW_FORMAT("Error: failed to decompress chunk of %s!", fName);
+
+		chunk.loaded = true;
+	});
+}
+
 void CLoadFile::openNextFile(const boost::filesystem::path & fname, ESerializationVersion minimalVersion)
 {
 	serializer.loadingGamestate = true;
@@ -68,6 +171,9 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, ESerializati
 			else
 				THROW_FORMAT("Error: too new file format (%s)!", fName);
 		}
+
+		if(serializer.version >= ESerializationVersion::CHUNKED_SAVE_FORMAT)
+			readChunksTable();
 	}
 	catch(...)
 	{
@@ -80,12 +186,15 @@ void CLoadFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CLoadFile");
 	if(!!sfile && *sfile)
-		out->debug("\tOpened %s Position: %d", fName, sfile->tellg());
+		out->debug("\tOpened %s Position: %d, chunk %d of %d", fName, sfile->tellg(), currentChunk, chunks.size());
 }
 
 void CLoadFile::clear()
 {
 	sfile = nullptr;
+	chunks.clear();
+	currentChunk = 0;
+	chunkPosition = 0;
 	fName.clear();
 	serializer.version = ESerializationVersion::NONE;
 }
@@ -13,8 +13,26 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Reads save file. Compressed chunks of saves are decompressed only once reading reaches them:
+/// header section one chunk at a time, and all remaining sections at once, in parallel
 class DLL_LINKAGE CLoadFile : public IBinaryReader
 {
+	struct Chunk
+	{
+		uint32_t section = 0;
+		uint32_t uncompressedSize = 0;
+		uint32_t compressedSize = 0;
+		bool loaded = false;
+		std::vector<std::byte> data;
+	};
+
+	std::vector<Chunk> chunks; // empty for saves in old, not chunked format
+	size_t currentChunk = 0;
+	size_t chunkPosition = 0;
+
+	void readChunksTable();
+	void loadChunks(size_t firstChunk);
+
 public:
 	BinaryDeserializer serializer;
 
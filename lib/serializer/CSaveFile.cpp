@@ -10,6 +10,9 @@
 #include "StdInc.h"
 #include "CSaveFile.h"
 
+#include <tbb/parallel_for.h>
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 CSaveFile::CSaveFile(const boost::filesystem::path &fname)
@@ -23,28 +26,95 @@ CSaveFile::~CSaveFile() = default;
 
 int CSaveFile::write(const std::byte * data, unsigned size)
 {
-	sfile->write(reinterpret_cast<const char *>(data), size);
+	buffer.insert(buffer.end(), data, data + size);
 	return size;
 }
 
 void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 {
 	fName = fname;
+	buffer.clear();
+
+	const char magic[] = "VCMI"; //write magic identifier
+	write(reinterpret_cast<const std::byte *>(magic), 4);
+	serializer & ESerializationVersion::CURRENT; //write format version
+
+	// magic identifier and version are written uncompressed, everything after them belongs to header section
+	sectionStarts = { buffer.size() };
+}
+
+void CSaveFile::beginSection()
+{
+	sectionStarts.push_back(buffer.size());
+}
+
+void CSaveFile::writeToDisk() const
+{
+	struct Chunk
+	{
+		uint32_t section;
+		size_t begin;
+		size_t end;
+		std::vector<std::byte> compressed;
+	};
+
+	std::vector<Chunk> chunks;
+	for(size_t section = 0; section < sectionStarts.size(); ++section)
+	{
+		size_t sectionEnd = section + 1 < sectionStarts.size() ? sectionStarts[section + 1] : buffer.size();
+
+		for(size_t begin = sectionStarts[section]; begin < sectionEnd; begin += maxChunkSize)
+			chunks.push_back({static_cast<uint32_t>(section), begin, std::min(begin + maxChunkSize, sectionEnd), {}});
+	}
+
+	tbb::parallel_for(static_cast<size_t>(0), chunks.size(), [this, &chunks](size_t index)
+	{
+		auto & chunk = chunks[index];
+		uLongf compressedSize = compressBound(chunk.end - chunk.begin);
+
+		chunk.compressed.resize(compressedSize);
+		int result = compress2(reinterpret_cast<Bytef *>(chunk.compressed.data()), &compressedSize, reinterpret_cast<const Bytef *>(buffer.data() + chunk.begin), chunk.end - chunk.begin, Z_DEFAULT_COMPRESSION);
+		if(result != Z_OK)
+			THROW_FORMAT("Error: failed to compress save %s!", fName.string());
+		chunk.compressed.resize(compressedSize);
+	});
+
+	boost::filesystem::path tempName = fName;
+	tempName += ".tmp";
+
 	try
 	{
-		sfile = std::make_unique<std::fstream>(fname.c_str(), std::ios::out | std::ios::binary);
-		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
+		{
+			std::fstream file(tempName.c_str(), std::ios::out | std::ios::binary);
+			file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+			auto writeValue = [&file](uint32_t value)
+			{
+				file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+			};
+
+			file.write(reinterpret_cast<const char *>(buffer.data()), sectionStarts.front());
 
-		if(!(*sfile))
-			THROW_FORMAT("Error: cannot open to write %s!", fname);
+			writeValue(chunks.size());
+			for(const auto & chunk : chunks)
+			{
+				writeValue(chunk.section);
+				writeValue(chunk.end - chunk.begin);
+				writeValue(chunk.compressed.size());
+			}
 
-		sfile->write("VCMI",4); //write magic identifier
-		serializer & ESerializationVersion::CURRENT; //write format version
+			for(const auto & chunk : chunks)
+				file.write(reinterpret_cast<const char *>(chunk.compressed.data()), chunk.compressed.size());
+		}
+
+		// rename is atomic, so save is never left partially written, even if game is terminated
+		boost::filesystem::rename(tempName, fName);
 	}
 	catch(...)
 	{
-		logGlobal->error("Failed to save to %s", fname.string());
-		clear();
+		logGlobal->error("Failed to save to %s", fName.string());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempName, ec);
 		throw;
 	}
 }
@@ -52,16 +122,14 @@ void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 void CSaveFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CSaveFile");
-	if(sfile.get() && *sfile)
-	{
-		out->debug("\tOpened %s \tPosition: %d", fName, sfile->tellp());
-	}
+	out->debug("	Saving to %s 	Serialized: %d bytes in %d sections", fName, buffer.size(), sectionStarts.size());
 }
 
 void CSaveFile::clear()
 {
 	fName.clear();
-	sfile = nullptr;
+	buffer.clear();
+	sectionStarts.clear();
 }
 
 void CSaveFile::putMagicBytes(const std::string &text)
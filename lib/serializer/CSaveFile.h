@@ -13,22 +13,35 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Serializes data into memory buffer, which is written to disk only by explicit writeToDisk call
+/// This allows to snapshot state quickly and to perform slow disk write separately, e.g. on another thread
+/// On disk, data is split into sections and chunks, each compressed independently from each other
 class DLL_LINKAGE CSaveFile : public IBinaryWriter
 {
 public:
+	/// Maximal size of uncompressed chunk. Smaller chunks allow more parallelism on save & load
+	static constexpr size_t maxChunkSize = 4 * 1024 * 1024;
+
 	BinarySerializer serializer;
 
 	boost::filesystem::path fName;
-	std::unique_ptr<std::fstream> sfile;
+	std::vector<std::byte> buffer;
+	std::vector<size_t> sectionStarts; // offsets in buffer
 
-	CSaveFile(const boost::filesystem::path &fname); //throws!
+	CSaveFile(const boost::filesystem::path &fname);
 	~CSaveFile();
 	int write(const std::byte * data, unsigned size) override;
 
-	void openNextFile(const boost::filesystem::path &fname); //throws!
+	void openNextFile(const boost::filesystem::path &fname);
 	void clear();
 	void reportState(vstd::CLoggerBase * out) override;
 
+	/// Starts new section of save. First section (header) can be loaded without decompressing following sections
+	void beginSection();
+
+	/// Writes serialized data to file. File is replaced only after data has been written completely
+	void writeToDisk() const; //throws!
+
 	void putMagicBytes(const std::string &text);
 
 	template<class T>
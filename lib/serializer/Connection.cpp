@@ -30,7 +30,8 @@ public:
 class DLL_LINKAGE ConnectionPackReader final : public IBinaryReader
 {
 public:
-	const std::vector<std::byte> * buffer;
+	const std::byte * buffer;
+	size_t size;
 	size_t position;
 
 	int read(std::byte * data, unsigned size) final;
@@ -44,10 +45,10 @@ int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 
 int ConnectionPackReader::read(std::byte * data, unsigned size)
 {
-	if (position + size > buffer->size())
+	if (position + size > this->size)
 		throw std::runtime_error("End of file reached when reading received network pack!");
 
-	std::copy_n(buffer->begin() + position, size, data);
+	std::copy_n(buffer + position, size, data);
 	position += size;
 	return size;
 }
@@ -77,21 +78,95 @@ void CConnection::sendPack(const CPack * pack)
 	if (!connectionPtr)
 		throw std::runtime_error("Attempt to send packet on a closed connection!");
 
+	logNetwork->trace("Sending a pack of type %s", typeid(*pack).name());
+
+	connectionPtr->sendPacket(serializePack(pack));
+}
+
+std::shared_ptr<const std::vector<std::byte>> CConnection::encodePack(const CPack * pack)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	return serializePack(pack);
+}
+
+std::shared_ptr<const std::vector<std::byte>> CConnection::serializePack(const CPack * pack)
+{
 	packWriter->buffer.clear();
 	*serializer & pack;
 
-	logNetwork->trace("Sending a pack of type %s", typeid(*pack).name());
-
-	connectionPtr->sendPacket(packWriter->buffer);
+	// buffer is moved into packet that may outlive this call while it waits in send queues
+	auto result = std::make_shared<const std::vector<std::byte>>(std::move(packWriter->buffer));
 	packWriter->buffer.clear();
 	serializer->savedPointers.clear();
+	if (perPackStringTable)
+		serializer->savedStrings.clear();
+	return result;
+}
+
+void CConnection::sendEncodedPack(const std::shared_ptr<const std::vector<std::byte>> & data)
+{
+	auto connectionPtr = networkConnection.lock();
+
+	if (!connectionPtr)
+		throw std::runtime_error("Attempt to send packet on a closed connection!");
+
+	connectionPtr->sendPacket(data);
+}
+
+NetworkMessage CConnection::prepareEncodedPack(const std::shared_ptr<const std::vector<std::byte>> & data) const
+{
+	auto connectionPtr = networkConnection.lock();
+
+	if (!connectionPtr)
+		throw std::runtime_error("Attempt to send packet on a closed connection!");
+
+	return connectionPtr->prepareMessage(data);
+}
+
+void CConnection::sendPreparedPack(const NetworkMessage & message)
+{
+	auto connectionPtr = networkConnection.lock();
+
+	if (!connectionPtr)
+		throw std::runtime_error("Attempt to send packet on a closed connection!");
+
+	connectionPtr->sendMessage(message);
+}
+
+uint32_t CConnection::getCompressionThreshold() const
+{
+	auto connectionPtr = networkConnection.lock();
+	return connectionPtr ? connectionPtr->getCompressionThreshold() : 0;
+}
+
+bool CConnection::hasSameSerializationSettings(const CConnection & other) const
+{
+	// older versions keep string table between packs, so their encoding depends on all previously sent packs
+	if (!perPackStringTable || !other.perPackStringTable)
+		return this == &other;
+
+	return serializer->version == other.serializer->version
+		&& packWriter->sendStackInstanceByIds == other.packWriter->sendStackInstanceByIds
+		&& packWriter->smartVectorMembersSerialization == other.packWriter->smartVectorMembersSerialization;
+}
+
+bool CConnection::hasSerializationFeature(ESerializationVersion what) const
+{
+	return serializer->hasFeature(what);
 }
 
 CPack * CConnection::retrievePack(const std::vector<std::byte> & data)
+{
+	return retrievePack(data.data(), data.size());
+}
+
+CPack * CConnection::retrievePack(const std::byte * data, size_t size)
 {
 	CPack * result;
 
-	packReader->buffer = &data;
+	packReader->buffer = data;
+	packReader->size = size;
 	packReader->position = 0;
 
 	*deserializer & result;
@@ -99,12 +174,14 @@ CPack * CConnection::retrievePack(const std::vector<std::byte> & data)
 	if (result == nullptr)
 		throw std::runtime_error("Failed to retrieve pack!");
 
-	if (packReader->position != data.size())
+	if (packReader->position != size)
 		throw std::runtime_error("Failed to retrieve pack! Not all data has been read!");
 
 	logNetwork->trace("Received CPack of type %s", typeid(*result).name());
 	deserializer->loadedPointers.clear();
 	deserializer->loadedSharedPointers.clear();
+	if (perPackStringTable)
+		deserializer->loadedStrings.clear();
 	return result;
 }
 
@@ -165,8 +242,24 @@ void CConnection::enableSmartVectorMemberSerializatoin(CGameState * gs)
 
 void CConnection::setSerializationVersion(ESerializationVersion version)
 {
+	// messages smaller than that are usually sent faster than compressed
+	constexpr uint32_t compressionThreshold = 4 * 1024;
+
 	deserializer->version = version;
 	serializer->version = version;
+
+	// Handshake packs are encoded with string table shared between packs, as in older versions.
+	// If both sides support it, both tables start anew right after handshake, as the last pack that could reference them has been processed
+	perPackStringTable = version >= ESerializationVersion::PER_PACK_STRING_TABLE;
+	if (perPackStringTable)
+	{
+		deserializer->loadedStrings.clear();
+		serializer->savedStrings.clear();
+	}
+
+	auto connectionPtr = networkConnection.lock();
+	if (connectionPtr)
+		connectionPtr->setCompressionThreshold(version >= ESerializationVersion::NETWORK_COMPRESSION ? compressionThreshold : 0);
 }
 
 VCMI_LIB_NAMESPACE_END
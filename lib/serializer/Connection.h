@@ -17,6 +17,7 @@ class BinaryDeserializer;
 class BinarySerializer;
 struct CPack;
 class INetworkConnection;
+struct NetworkMessage;
 class ConnectionPackReader;
 class ConnectionPackWriter;
 class CGameState;
@@ -36,11 +37,17 @@ class DLL_LINKAGE CConnection : boost::noncopyable
 
 	boost::mutex writeMutex;
 
+	/// Strings are referenced only within single pack. Enabled once both sides agreed on version that supports it
+	bool perPackStringTable = false;
+
 	void disableStackSendingByID();
 	void enableStackSendingByID();
 	void disableSmartVectorMemberSerialization();
 	void enableSmartVectorMemberSerializatoin(CGameState * gs);
 
+	/// Serializes pack into new buffer, writeMutex must be locked by caller
+	std::shared_ptr<const std::vector<std::byte>> serializePack(const CPack * pack);
+
 public:
 	bool isMyConnection(const std::shared_ptr<INetworkConnection> & otherConnection) const;
 	std::shared_ptr<INetworkConnection> getConnection();
@@ -52,7 +59,20 @@ public:
 	~CConnection();
 
 	void sendPack(const CPack * pack);
+
+	/// Serializes pack once so it can be sent to all connections with same serialization settings
+	std::shared_ptr<const std::vector<std::byte>> encodePack(const CPack * pack);
+	void sendEncodedPack(const std::shared_ptr<const std::vector<std::byte>> & data);
+	/// Compresses encoded pack if this connection uses compression, without locking the connection
+	/// Result can be sent by all connections with same compression threshold
+	NetworkMessage prepareEncodedPack(const std::shared_ptr<const std::vector<std::byte>> & data) const;
+	void sendPreparedPack(const NetworkMessage & message);
+	uint32_t getCompressionThreshold() const;
+	bool hasSameSerializationSettings(const CConnection & other) const;
+	bool hasSerializationFeature(ESerializationVersion what) const;
+
 	CPack * retrievePack(const std::vector<std::byte> & data);
+	CPack * retrievePack(const std::byte * data, size_t size);
 
 	void enterLobbyConnectionMode();
 	void setCallback(IGameCallback * cb);
@@ -56,6 +56,11 @@ enum class ESerializationVersion : int32_t
 	NEW_MARKETS, // 857 - reworked market classes
 	PLAYER_STATE_OWNED_OBJECTS, // 858 - player state stores all owned objects in a single list
 	SAVE_COMPATIBILITY_FIXES, // 859 - implementation of previoulsy postponed changes to serialization
+	PER_PACK_STRING_TABLE, // 860 - network packs do not reference strings from previous packs, so encoded pack can be shared by connections
+	NETWORK_PACK_BATCH, // 861 - packs generated by single server action can be sent as single network message
+	FOG_OF_WAR_SPANS, // 862 - tiles of fog of war changes are serialized as runs of consecutive tiles
+	NETWORK_COMPRESSION, // 863 - large network messages may be compressed
+	CHUNKED_SAVE_FORMAT, // 864 - saves consist of independently compressed chunks, header can be read without rest of the save
 
-	CURRENT = SAVE_COMPATIBILITY_FIXES
+	CURRENT = CHUNKED_SAVE_FORMAT
 };
@@ -294,6 +294,7 @@ void registerTypes(Serializer &s)
 	s.template registerType<LobbySetDifficulty>(238);
 	s.template registerType<LobbyForceSetPlayer>(239);
 	s.template registerType<LobbySetExtraOptions>(240);
+	s.template registerType<PackBatch>(241);
 }
 
 VCMI_LIB_NAMESPACE_END
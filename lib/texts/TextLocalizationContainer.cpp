@@ -20,11 +20,11 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-std::recursive_mutex TextLocalizationContainer::globalTextMutex;
+boost::shared_mutex TextLocalizationContainer::globalTextMutex;
 
 void TextLocalizationContainer::registerStringOverride(const std::string & modContext, const std::string & language, const TextIdentifier & UID, const std::string & localized)
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextWriteLock globalLock(globalTextMutex);
 
 	assert(!modContext.empty());
 	assert(!language.empty());
@@ -40,7 +40,7 @@ void TextLocalizationContainer::registerStringOverride(const std::string & modCo
 
 void TextLocalizationContainer::addSubContainer(const TextLocalizationContainer & container)
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextWriteLock globalLock(globalTextMutex);
 
 	assert(!vstd::contains(subContainers, &container));
 	subContainers.push_back(&container);
@@ -48,58 +48,61 @@ void TextLocalizationContainer::addSubContainer(const TextLocalizationContainer
 
 void TextLocalizationContainer::removeSubContainer(const TextLocalizationContainer & container)
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextWriteLock globalLock(globalTextMutex);
 
 	assert(vstd::contains(subContainers, &container));
 
 	subContainers.erase(std::remove(subContainers.begin(), subContainers.end(), &container), subContainers.end());
 }
 
-const std::string & TextLocalizationContainer::deserialize(const TextIdentifier & identifier) const
+const TextLocalizationContainer::StringState * TextLocalizationContainer::findString(const std::string & identifier) const
 {
-	std::lock_guard globalLock(globalTextMutex);
+	auto it = stringsLocalizations.find(identifier);
+	if(it != stringsLocalizations.end())
+		return &it->second;
 
-	if(stringsLocalizations.count(identifier.get()) == 0)
+	for(auto containerIter = subContainers.rbegin(); containerIter != subContainers.rend(); ++containerIter)
 	{
-		for(auto containerIter = subContainers.rbegin(); containerIter != subContainers.rend(); ++containerIter)
-			if((*containerIter)->identifierExists(identifier))
-				return (*containerIter)->deserialize(identifier);
+		auto subIt = (*containerIter)->stringsLocalizations.find(identifier);
+		if(subIt != (*containerIter)->stringsLocalizations.end())
+			return &subIt->second;
+	}
+	return nullptr;
+}
 
+const std::string & TextLocalizationContainer::deserialize(const TextIdentifier & identifier) const
+{
+	TextReadLock globalLock(globalTextMutex);
+
+	const StringState * entry = findString(identifier.get());
+
+	if(entry == nullptr)
+	{
 		logGlobal->error("Unable to find localization for string '%s'", identifier.get());
 		return identifier.get();
 	}
 
-	const auto & entry = stringsLocalizations.at(identifier.get());
-
-	if (!entry.overrideValue.empty())
-		return entry.overrideValue;
-	return entry.baseValue;
+	if (!entry->overrideValue.empty())
+		return entry->overrideValue;
+	return entry->baseValue;
 }
 
 void TextLocalizationContainer::registerString(const std::string & modContext, const TextIdentifier & UID, const std::string & localized, const std::string & language)
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextWriteLock globalLock(globalTextMutex);
 
 	assert(!modContext.empty());
 	assert(!Languages::getLanguageOptions(language).identifier.empty());
 	assert(UID.get().find("..") == std::string::npos); // invalid identifier - there is section that was evaluated to empty string
 	//assert(stringsLocalizations.count(UID.get()) == 0); // registering already registered string?
 
-	if(stringsLocalizations.count(UID.get()) > 0)
-	{
-		auto & value = stringsLocalizations[UID.get()];
-		value.baseLanguage = language;
-		value.baseValue = localized;
-	}
-	else
-	{
-		StringState value;
-		value.baseLanguage = language;
-		value.baseValue = localized;
-		value.modContext = modContext;
+	auto [entry, inserted] = stringsLocalizations.try_emplace(UID.get());
+	auto & value = entry->second;
 
-		stringsLocalizations[UID.get()] = value;
-	}
+	value.baseLanguage = language;
+	value.baseValue = localized;
+	if(inserted)
+		value.modContext = modContext;
 }
 
 void TextLocalizationContainer::registerString(const std::string & modContext, const TextIdentifier & UID, const std::string & localized)
@@ -110,7 +113,7 @@ void TextLocalizationContainer::registerString(const std::string & modContext, c
 
 bool TextLocalizationContainer::validateTranslation(const std::string & language, const std::string & modContext, const JsonNode & config) const
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextReadLock globalLock(globalTextMutex);
 
 	bool allPresent = true;
 
@@ -169,17 +172,22 @@ void TextLocalizationContainer::loadTranslationOverrides(const std::string & lan
 
 bool TextLocalizationContainer::identifierExists(const TextIdentifier & UID) const
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextReadLock globalLock(globalTextMutex);
 
 	return stringsLocalizations.count(UID.get());
 }
 
 void TextLocalizationContainer::exportAllTexts(std::map<std::string, std::map<std::string, std::string>> & storage) const
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextReadLock globalLock(globalTextMutex);
+
+	exportTexts(storage);
+}
 
+void TextLocalizationContainer::exportTexts(std::map<std::string, std::map<std::string, std::string>> & storage) const
+{
 	for (auto const & subContainer : subContainers)
-		subContainer->exportAllTexts(storage);
+		subContainer->exportTexts(storage);
 
 	for (auto const & entry : stringsLocalizations)
 	{
@@ -207,7 +215,7 @@ std::string TextLocalizationContainer::getModLanguage(const std::string & modCon
 
 void TextLocalizationContainer::jsonSerialize(JsonNode & dest) const
 {
-	std::lock_guard globalLock(globalTextMutex);
+	TextReadLock globalLock(globalTextMutex);
 
 	for(auto & s : stringsLocalizations)
 	{
@@ -18,7 +18,11 @@ class JsonNode;
 class DLL_LINKAGE TextLocalizationContainer
 {
 protected:
-	static std::recursive_mutex globalTextMutex;
+	/// Texts are read from many threads (UI, AI, server), but modified rarely
+	/// Readers take shared lock, so they never block each other. Registration of texts or containers is exclusive
+	static boost::shared_mutex globalTextMutex;
+	using TextReadLock = boost::shared_lock<boost::shared_mutex>;
+	using TextWriteLock = boost::unique_lock<boost::shared_mutex>;
 
 	struct StringState
 	{
@@ -51,6 +55,12 @@ protected:
 
 	std::vector<const TextLocalizationContainer *> subContainers;
 
+	/// Finds string in this container or in one of its subcontainers. Caller must hold globalTextMutex
+	const StringState * findString(const std::string & identifier) const;
+
+	/// Implementation of exportAllTexts. Caller must hold globalTextMutex
+	void exportTexts(std::map<std::string, std::map<std::string, std::string>> & storage) const;
+
 	/// add selected string to internal storage as high-priority strings
 	void registerStringOverride(const std::string & modContext, const std::string & language, const TextIdentifier & UID, const std::string & localized);
 
@@ -99,7 +109,7 @@ public:
 	template <typename Handler>
 	void serialize(Handler & h)
 	{
-		std::lock_guard globalLock(globalTextMutex);
+		TextWriteLock globalLock(globalTextMutex);
 
 		if (h.version >= Handler::Version::SIMPLE_TEXT_CONTAINER_SERIALIZATION)
 		{
@@ -339,12 +339,18 @@ void LobbyDatabase::prepareStatements()
 
 LobbyDatabase::~LobbyDatabase() = default;
 
-LobbyDatabase::LobbyDatabase(const boost::filesystem::path & databasePath)
+LobbyDatabase::LobbyDatabase(const boost::filesystem::path & databasePath, bool allowWrite)
 {
-	database = SQLiteInstance::open(databasePath, true);
-	createTables();
-	upgradeDatabase();
-	clearOldData();
+	database = SQLiteInstance::open(databasePath, allowWrite);
+
+	if (allowWrite)
+	{
+		// lets read-only connections run queries while this connection is writing
+		database->prepare("PRAGMA journal_mode=WAL")->execute();
+		createTables();
+		upgradeDatabase();
+		clearOldData();
+	}
 	prepareStatements();
 }
 
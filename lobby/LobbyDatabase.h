@@ -65,7 +65,8 @@ class LobbyDatabase
 	void clearOldData();
 
 public:
-	explicit LobbyDatabase(const boost::filesystem::path & databasePath);
+	/// Read-only connection can be opened only after database has been created by connection that allows writing
+	explicit LobbyDatabase(const boost::filesystem::path & databasePath, bool allowWrite = true);
 	~LobbyDatabase();
 
 	void setAccountOnline(const std::string & accountID, bool isOnline);
@@ -12,6 +12,7 @@
 
 #include "LobbyDatabase.h"
 
+#include "../lib/CThreadHelper.h"
 #include "../lib/json/JsonFormatException.h"
 #include "../lib/json/JsonNode.h"
 #include "../lib/json/JsonUtils.h"
@@ -61,6 +62,20 @@ std::string LobbyServer::sanitizeChatMessage(const std::string & inputString) co
 	return boost::trim_copy(sanitized);
 }
 
+template<typename Query, typename Callback>
+void LobbyServer::runQuery(Query && query, Callback && callback)
+{
+	boost::asio::post(queryThread, [this, query = std::forward<Query>(query), callback = std::forward<Callback>(callback)]() mutable
+	{
+		auto result = query(*queryDatabase);
+
+		boost::asio::post(lobbyThread, [callback = std::move(callback), result = std::move(result)]() mutable
+		{
+			callback(result);
+		});
+	});
+}
+
 NetworkConnectionPtr LobbyServer::findAccount(const std::string & accountID) const
 {
 	for(const auto & account : activeAccounts)
@@ -119,6 +134,7 @@ void LobbyServer::sendClientLoginSuccess(const NetworkConnectionPtr & target, co
 	reply["type"].String() = "clientLoginSuccess";
 	reply["accountCookie"].String() = accountCookie;
 	reply["displayName"].String() = displayName;
+	reply["incrementalUpdates"].Bool() = true;
 	sendMessage(target, reply);
 }
 
@@ -132,16 +148,26 @@ void LobbyServer::sendServerLoginSuccess(const NetworkConnectionPtr & target, co
 
 void LobbyServer::sendFullChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName, const std::string & channelNameForClient)
 {
-	sendChatHistory(target, channelType, channelNameForClient, database->getFullMessageHistory(channelType, channelName));
+	runQuery(
+		[channelType, channelName](LobbyDatabase & db){ return db.getFullMessageHistory(channelType, channelName); },
+		[this, target, channelType, channelNameForClient](const std::vector<LobbyChatMessage> & history){ sendChatHistory(target, channelType, channelNameForClient, history); }
+	);
 }
 
 void LobbyServer::sendRecentChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName)
 {
-	sendChatHistory(target, channelType, channelName, database->getRecentMessageHistory(channelType, channelName));
+	runQuery(
+		[channelType, channelName](LobbyDatabase & db){ return db.getRecentMessageHistory(channelType, channelName); },
+		[this, target, channelType, channelName](const std::vector<LobbyChatMessage> & history){ sendChatHistory(target, channelType, channelName, history); }
+	);
 }
 
 void LobbyServer::sendChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName, const std::vector<LobbyChatMessage> & history)
 {
+	// connection may have been closed while query was running
+	if (!activeAccounts.count(target))
+		return;
+
 	JsonNode reply;
 	reply["type"].String() = "chatHistory";
 	reply["channelType"].String() = channelType;
@@ -163,25 +189,118 @@ void LobbyServer::sendChatHistory(const NetworkConnectionPtr & target, const std
 	sendMessage(target, reply);
 }
 
-void LobbyServer::broadcastActiveAccounts()
+static bool isSameListEntry(const JsonNode & left, const JsonNode & right, const std::string & ignoredField)
+{
+	if (ignoredField.empty())
+		return left == right;
+
+	const auto & leftFields = left.Struct();
+	const auto & rightFields = right.Struct();
+
+	if (leftFields.size() != rightFields.size())
+		return false;
+
+	for (auto leftIt = leftFields.begin(), rightIt = rightFields.begin(); leftIt != leftFields.end(); ++leftIt, ++rightIt)
+	{
+		if (leftIt->first != rightIt->first)
+			return false;
+
+		if (leftIt->first != ignoredField && leftIt->second != rightIt->second)
+			return false;
+	}
+	return true;
+}
+
+bool LobbyServer::BroadcastedList::update(std::map<std::string, JsonNode> && newEntries, JsonNode & changed, JsonNode & removed, const std::string & ignoredField)
+{
+	changed.Vector(); // force creation of empty vector
+	removed.Vector();
+
+	for(const auto & entry : newEntries)
+	{
+		auto oldEntry = entries.find(entry.first);
+		if (oldEntry == entries.end() || !isSameListEntry(oldEntry->second, entry.second, ignoredField))
+			changed.Vector().push_back(entry.second);
+	}
+
+	for(const auto & entry : entries)
+		if (newEntries.count(entry.first) == 0)
+			removed.Vector().push_back(JsonNode(entry.first));
+
+	entries = std::move(newEntries);
+	updateTime = std::chrono::steady_clock::now();
+
+	if (changed.Vector().empty() && removed.Vector().empty())
+		return false;
+
+	version += 1;
+	return true;
+}
+
+void LobbyServer::broadcastListUpdate(const JsonNode & update, const std::function<JsonNode()> & makeFullList)
 {
-	auto activeAccountsStats = database->getActiveAccounts();
+	NetworkPacketPtr updatePacket;
+	NetworkPacketPtr fullListPacket;
+
+	for(const auto & connection : activeAccounts)
+	{
+		if (incrementalUpdateAccounts.count(connection.first))
+		{
+			if (!updatePacket)
+				updatePacket = std::make_shared<const std::vector<std::byte>>(update.toBytes());
+			connection.first->sendPacket(updatePacket);
+		}
+		else
+		{
+			if (!fullListPacket)
+				fullListPacket = std::make_shared<const std::vector<std::byte>>(makeFullList().toBytes());
+			connection.first->sendPacket(fullListPacket);
+		}
+	}
+}
 
+JsonNode LobbyServer::prepareActiveAccounts()
+{
 	JsonNode reply;
 	reply["type"].String() = "activeAccounts";
+	reply["version"].Integer() = broadcastedAccounts.version;
 	reply["accounts"].Vector(); // force creation of empty vector
 
+	for(const auto & account : broadcastedAccounts.entries)
+		reply["accounts"].Vector().push_back(account.second);
+
+	return reply;
+}
+
+void LobbyServer::broadcastActiveAccounts()
+{
+	runQuery(
+		[](LobbyDatabase & db){ return db.getActiveAccounts(); },
+		[this](const std::vector<LobbyAccount> & activeAccountsStats){ broadcastActiveAccounts(activeAccountsStats); }
+	);
+}
+
+void LobbyServer::broadcastActiveAccounts(const std::vector<LobbyAccount> & activeAccountsStats)
+{
+	std::map<std::string, JsonNode> newEntries;
+
 	for(const auto & account : activeAccountsStats)
 	{
 		JsonNode jsonEntry;
 		jsonEntry["accountID"].String() = account.accountID;
 		jsonEntry["displayName"].String() = account.displayName;
 		jsonEntry["status"].String() = "In Lobby"; // TODO: in room status, in match status, offline status(?)
-		reply["accounts"].Vector().push_back(jsonEntry);
+		newEntries[account.accountID] = jsonEntry;
 	}
 
-	for(const auto & connection : activeAccounts)
-		sendMessage(connection.first, reply);
+	JsonNode update;
+	update["type"].String() = "activeAccountsUpdate";
+
+	if (!broadcastedAccounts.update(std::move(newEntries), update["changed"], update["removed"], ""))
+		return;
+
+	update["version"].Integer() = broadcastedAccounts.version;
+	broadcastListUpdate(update, [this](){ return prepareActiveAccounts(); });
 }
 
 static JsonNode loadLobbyAccountToJson(const LobbyAccount & account)
@@ -228,7 +347,18 @@ void LobbyServer::sendMatchesHistory(const NetworkConnectionPtr & target)
 {
 	std::string accountID = activeAccounts.at(target);
 
-	auto matchesHistory = database->getAccountGameHistory(accountID);
+	runQuery(
+		[accountID](LobbyDatabase & db){ return db.getAccountGameHistory(accountID); },
+		[this, target](const std::vector<LobbyGameRoom> & matchesHistory){ sendMatchesHistory(target, matchesHistory); }
+	);
+}
+
+void LobbyServer::sendMatchesHistory(const NetworkConnectionPtr & target, const std::vector<LobbyGameRoom> & matchesHistory)
+{
+	// connection may have been closed while query was running
+	if (!activeAccounts.count(target))
+		return;
+
 	JsonNode reply;
 	reply["type"].String() = "matchesHistory";
 	reply["matchesHistory"].Vector(); // force creation of empty vector
@@ -241,23 +371,53 @@ void LobbyServer::sendMatchesHistory(const NetworkConnectionPtr & target)
 
 JsonNode LobbyServer::prepareActiveGameRooms()
 {
-	auto activeGameRoomStats = database->getActiveGameRooms();
 	JsonNode reply;
 	reply["type"].String() = "activeGameRooms";
+	reply["version"].Integer() = broadcastedGameRooms.version;
 	reply["gameRooms"].Vector(); // force creation of empty vector
 
-	for(const auto & gameRoom : activeGameRoomStats)
-		reply["gameRooms"].Vector().push_back(loadLobbyGameRoomToJson(gameRoom));
+	// rooms were aged when list was last broadcasted, account for time that has passed since then
+	auto timePassed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - broadcastedGameRooms.updateTime);
+
+	for(const auto & gameRoom : broadcastedGameRooms.entries)
+	{
+		reply["gameRooms"].Vector().push_back(gameRoom.second);
+		reply["gameRooms"].Vector().back()["ageSeconds"].Integer() += timePassed.count();
+	}
+
+	// most recent rooms first, same as in database query
+	std::stable_sort(reply["gameRooms"].Vector().begin(), reply["gameRooms"].Vector().end(), [](const JsonNode & left, const JsonNode & right)
+	{
+		return left["ageSeconds"].Integer() < right["ageSeconds"].Integer();
+	});
 
 	return reply;
 }
 
 void LobbyServer::broadcastActiveGameRooms()
 {
-	auto reply = prepareActiveGameRooms();
+	runQuery(
+		[](LobbyDatabase & db){ return db.getActiveGameRooms(); },
+		[this](const std::vector<LobbyGameRoom> & activeGameRoomStats){ broadcastActiveGameRooms(activeGameRoomStats); }
+	);
+}
 
-	for(const auto & connection : activeAccounts)
-		sendMessage(connection.first, reply);
+void LobbyServer::broadcastActiveGameRooms(const std::vector<LobbyGameRoom> & activeGameRoomStats)
+{
+	std::map<std::string, JsonNode> newEntries;
+
+	for(const auto & gameRoom : activeGameRoomStats)
+		newEntries[gameRoom.roomID] = loadLobbyGameRoomToJson(gameRoom);
+
+	JsonNode update;
+	update["type"].String() = "activeGameRoomsUpdate";
+
+	// room age changes constantly and is only used by clients to compute room creation time
+	if (!broadcastedGameRooms.update(std::move(newEntries), update["changed"], update["removed"], "ageSeconds"))
+		return;
+
+	update["version"].Integer() = broadcastedGameRooms.version;
+	broadcastListUpdate(update, [this](){ return prepareActiveGameRooms(); });
 }
 
 void LobbyServer::sendAccountJoinsRoom(const NetworkConnectionPtr & target, const std::string & accountID)
@@ -297,12 +457,21 @@ void LobbyServer::onNewConnection(const NetworkConnectionPtr & connection)
 }
 
 void LobbyServer::onDisconnected(const NetworkConnectionPtr & connection, const std::string & errorMessage)
+{
+	boost::asio::post(lobbyThread, [this, connection]()
+	{
+		processDisconnected(connection);
+	});
+}
+
+void LobbyServer::processDisconnected(const NetworkConnectionPtr & connection)
 {
 	if(activeAccounts.count(connection))
 	{
 		logGlobal->info("Account %s disconnecting. Accounts online: %d", activeAccounts.at(connection), activeAccounts.size() - 1);
 		database->setAccountOnline(activeAccounts.at(connection), false);
 		activeAccounts.erase(connection);
+		incrementalUpdateAccounts.erase(connection);
 	}
 
 	if(activeGameRooms.count(connection))
@@ -323,15 +492,24 @@ void LobbyServer::onDisconnected(const NetworkConnectionPtr & connection, const
 		activeGameRooms.erase(connection);
 	}
 
-	if(activeProxies.count(connection))
 	{
-		const auto & otherConnection = activeProxies.at(connection);
+		std::lock_guard lock(proxiesMutex);
 
-		if (otherConnection)
-			otherConnection->close();
+		if(activeProxies.count(connection))
+		{
+			auto otherConnection = activeProxies.at(connection);
 
-		activeProxies.erase(connection);
-		activeProxies.erase(otherConnection);
+			if (otherConnection)
+			{
+				logRelayStatistics(connection, otherConnection);
+				otherConnection->close();
+			}
+
+			activeProxies.erase(connection);
+			activeProxies.erase(otherConnection);
+			relayStartTimes.erase(connection);
+			relayStartTimes.erase(otherConnection);
+		}
 	}
 
 	broadcastActiveAccounts();
@@ -379,18 +557,94 @@ JsonNode LobbyServer::parseAndValidateMessage(const std::vector<std::byte> & mes
 
 void LobbyServer::onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message)
 {
+	NetworkConnectionPtr proxyTarget;
+	bool isProxy = false;
+
+	{
+		std::lock_guard lock(proxiesMutex);
+
+		// proxy connection - redirect directly from network thread, unless
+		// earlier messages from the same connection are still queued and must not be overtaken
+		auto proxy = activeProxies.find(connection);
+		isProxy = proxy != activeProxies.end();
+		if(isProxy && proxy->second && pendingMessages.count(connection) == 0)
+			proxyTarget = proxy->second;
+		else
+			pendingMessages[connection] += 1;
+	}
+
+	if(proxyTarget)
+		return proxyTarget->sendPacket(message);
+
+	// parsing and validation run on strand of this connection, in parallel with other connections
+	JsonNode json;
+	if(!isProxy)
+		json = parseAndValidateMessage(message);
+
+	boost::asio::post(lobbyThread, [this, connection, message, json = std::move(json)]() mutable
+	{
+		processPacket(connection, message, std::move(json));
+
+		std::lock_guard lock(proxiesMutex);
+		if(--pendingMessages[connection] == 0)
+		{
+			pendingMessages.erase(connection);
+			enableRelayIfReady(connection);
+		}
+	});
+}
+
+void LobbyServer::enableRelayIfReady(const NetworkConnectionPtr & connection)
+{
+	if (relayStartTimes.count(connection) || pendingMessages.count(connection))
+		return;
+
+	auto proxy = activeProxies.find(connection);
+	if (proxy == activeProxies.end() || !proxy->second)
+		return;
+
+	// from now on, messages are forwarded by network thread without reaching lobby
+	connection->setRelayTarget(proxy->second);
+	relayStartTimes[connection] = std::chrono::steady_clock::now();
+}
+
+void LobbyServer::logRelayStatistics(const NetworkConnectionPtr & connection, const NetworkConnectionPtr & otherConnection)
+{
+	auto startTime = relayStartTimes.count(connection) ? relayStartTimes.at(connection) : std::chrono::steady_clock::now();
+	double seconds = std::max(1.0, std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+
+	auto sent = connection->getRelayStatistics();
+	auto received = otherConnection->getRelayStatistics();
+
+	logGlobal->info("Proxy closed after %.0f s. Relayed %d messages, %d bytes (%.1f KB/s) in one direction and %d messages, %d bytes (%.1f KB/s) in another",
+		seconds, sent.messages, sent.bytes, sent.bytes / seconds / 1024, received.messages, received.bytes, received.bytes / seconds / 1024);
+}
+
+void LobbyServer::processPacket(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message, JsonNode json)
+{
+	NetworkConnectionPtr proxyTarget;
+	bool isProxy = false;
+
+	{
+		std::lock_guard lock(proxiesMutex);
+		auto proxy = activeProxies.find(connection);
+		if(proxy != activeProxies.end())
+		{
+			isProxy = true;
+			proxyTarget = proxy->second;
+		}
+	}
+
 	// proxy connection - no processing, only redirect
-	if(activeProxies.count(connection))
+	if(isProxy)
 	{
-		auto lockedPtr = activeProxies.at(connection);
-		if(lockedPtr)
-			return lockedPtr->sendPacket(message);
+		if(proxyTarget)
+			return proxyTarget->sendPacket(message);
 
 		logGlobal->info("Received unexpected message for inactive proxy!");
+		json = parseAndValidateMessage(message);
 	}
 
-	JsonNode json = parseAndValidateMessage(message);
-
 	std::string messageType = json["type"].String();
 
 	// communication messages from vcmiclient
@@ -405,6 +659,12 @@ void LobbyServer::onPacketReceived(const NetworkConnectionPtr & connection, cons
 		if(messageType == "requestChatHistory")
 			return receiveRequestChatHistory(connection, json);
 
+		if(messageType == "requestActiveLists")
+			return receiveRequestActiveLists(connection, json);
+
+		if(messageType == "enableIncrementalUpdates")
+			return receiveEnableIncrementalUpdates(connection, json);
+
 		if(messageType == "activateGameRoom")
 			return receiveActivateGameRoom(connection, json);
 
@@ -490,6 +750,19 @@ void LobbyServer::receiveRequestChatHistory(const NetworkConnectionPtr & connect
 	}
 }
 
+void LobbyServer::receiveRequestActiveLists(const NetworkConnectionPtr & connection, const JsonNode & json)
+{
+	// client has missed an update - resend both lists in full to this client only
+	sendMessage(connection, prepareActiveAccounts());
+	sendMessage(connection, prepareActiveGameRooms());
+}
+
+void LobbyServer::receiveEnableIncrementalUpdates(const NetworkConnectionPtr & connection, const JsonNode & json)
+{
+	// full lists were already sent on login, any change after this point will be sent as update
+	incrementalUpdateAccounts.insert(connection);
+}
+
 void LobbyServer::receiveSendChatMessage(const NetworkConnectionPtr & connection, const JsonNode & json)
 {
 	std::string senderAccountID = activeAccounts[connection];
@@ -602,6 +875,11 @@ void LobbyServer::receiveClientLogin(const NetworkConnectionPtr & connection, co
 
 	std::string displayName = database->getAccountDisplayName(accountID);
 
+	// Lists are queried asynchronously and will be broadcasted once query completes, including to new account added below
+	// Until then, new account receives full lists as they were last broadcasted, which may not contain it yet
+	broadcastActiveAccounts();
+	broadcastActiveGameRooms();
+
 	activeAccounts[connection] = accountID;
 
 	logGlobal->info("%s: Logged in as %s", accountID, displayName);
@@ -610,9 +888,8 @@ void LobbyServer::receiveClientLogin(const NetworkConnectionPtr & connection, co
 	if (language != "english")
 		sendRecentChatHistory(connection, "global", language);
 
-	// send active game rooms list to new account
-	// and update account list to everybody else including new account
-	broadcastActiveAccounts();
+	// send last broadcasted lists of accounts and game rooms to new account
+	sendMessage(connection, prepareActiveAccounts());
 	sendMessage(connection, prepareActiveGameRooms());
 	sendMatchesHistory(connection);
 }
@@ -663,8 +940,12 @@ void LobbyServer::receiveClientProxyLogin(const NetworkConnectionPtr & connectio
 
 			if(gameRoomConnection)
 			{
+				std::lock_guard lock(proxiesMutex);
 				activeProxies[gameRoomConnection] = connection;
 				activeProxies[connection] = gameRoomConnection;
+
+				// this connection still has login message pending, so it is switched only once it has been processed
+				enableRelayIfReady(gameRoomConnection);
 			}
 			return;
 		}
@@ -827,8 +1108,11 @@ LobbyServer::~LobbyServer() = default;
 
 LobbyServer::LobbyServer(const boost::filesystem::path & databasePath)
 	: database(std::make_unique<LobbyDatabase>(databasePath))
+	, queryDatabase(std::make_unique<LobbyDatabase>(databasePath, false))
 	, networkHandler(INetworkHandler::createHandler())
 	, networkServer(networkHandler->createServerTCP(*this))
+	, lobbyThread(1)
+	, queryThread(1)
 {
 }
 
@@ -839,5 +1123,28 @@ void LobbyServer::start(uint16_t port)
 
 void LobbyServer::run()
 {
+	boost::asio::post(lobbyThread, [](){ setThreadName("lobbyThread"); });
+	boost::asio::post(queryThread, [](){ setThreadName("lobbyQueries"); });
+
+	// handlers of a single connection are serialized by its strand, so network can be run by any number of threads
+	unsigned int threadsCount = std::max(1u, boost::thread::hardware_concurrency());
+	logGlobal->info("Starting %d network threads", threadsCount);
+
+	std::vector<boost::thread> networkThreads;
+	for (unsigned int i = 1; i < threadsCount; ++i)
+	{
+		networkThreads.emplace_back([this, i]()
+		{
+			setThreadName("network_" + std::to_string(i));
+			networkHandler->run();
+		});
+	}
+
 	networkHandler->run();
+
+	for (auto & thread : networkThreads)
+		thread.join();
+
+	queryThread.join();
+	lobbyThread.join();
 }
@@ -9,12 +9,12 @@
  */
 #pragma once
 
+#include "../lib/json/JsonNode.h"
 #include "../lib/network/NetworkInterface.h"
 #include "LobbyDefines.h"
 
-VCMI_LIB_NAMESPACE_BEGIN
-class JsonNode;
-VCMI_LIB_NAMESPACE_END
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 class LobbyDatabase;
 
@@ -31,6 +31,15 @@ class LobbyServer final : public INetworkServerListener
 	/// list of connected proxies. All messages received from (key) will be redirected to (value) connection
 	std::map<NetworkConnectionPtr, NetworkConnectionPtr> activeProxies;
 
+	/// number of messages from connection that were received but not yet processed by lobby thread
+	std::map<NetworkConnectionPtr, size_t> pendingMessages;
+
+	/// proxy connections that were switched into relay mode, with time of the switch
+	std::map<NetworkConnectionPtr, std::chrono::steady_clock::time_point> relayStartTimes;
+
+	/// protects activeProxies, pendingMessages and relayStartTimes that are also accessed by network threads
+	std::mutex proxiesMutex;
+
 	/// list of half-established proxies from server that are still waiting for client to connect
 	std::vector<AwaitingProxyState> awaitingProxies;
 
@@ -40,10 +49,44 @@ class LobbyServer final : public INetworkServerListener
 	/// list of currently logged in game rooms (vcmiserver's)
 	std::map<NetworkConnectionPtr, std::string> activeGameRooms;
 
+	/// Last version of list of active accounts or game rooms that was sent to clients
+	struct BroadcastedList
+	{
+		int64_t version = 0;
+		std::map<std::string, JsonNode> entries;
+		/// time when entries were last replaced, used to compute current age of game rooms
+		std::chrono::steady_clock::time_point updateTime;
+
+		/// Replaces entries with new state and increments version if anything has changed
+		/// Entries that were added or modified are written into 'changed', IDs of entries that are no longer present - into 'removed'
+		/// Field 'ignoredField', if set, is not considered to be a change on its own
+		bool update(std::map<std::string, JsonNode> && newEntries, JsonNode & changed, JsonNode & removed, const std::string & ignoredField);
+	};
+
+	BroadcastedList broadcastedAccounts;
+	BroadcastedList broadcastedGameRooms;
+
+	/// logged in accounts that can apply incremental updates of account and room lists
+	std::set<NetworkConnectionPtr> incrementalUpdateAccounts;
+
 	std::unique_ptr<LobbyDatabase> database;
+	/// read-only connection to the same database, only used by queryThread
+	std::unique_ptr<LobbyDatabase> queryDatabase;
 	std::unique_ptr<INetworkHandler> networkHandler;
 	std::unique_ptr<INetworkServer> networkServer;
 
+	/// single thread that owns all lobby state and performs database updates
+	/// network threads perform I/O, proxy relaying, parsing and validation of messages and post everything else here
+	boost::asio::thread_pool lobbyThread;
+
+	/// runs heavy read-only queries, such as chat and match histories and lists of active accounts and rooms
+	/// so they don't stall processing of messages on lobby thread
+	boost::asio::thread_pool queryThread;
+
+	/// Runs query on query thread and passes its result to callback on lobby thread
+	template<typename Query, typename Callback>
+	void runQuery(Query && query, Callback && callback);
+
 	/// removes any "weird" symbols from chat message that might break UI
 	std::string sanitizeChatMessage(const std::string & inputString) const;
 
@@ -56,11 +99,27 @@ class LobbyServer final : public INetworkServerListener
 	void onDisconnected(const NetworkConnectionPtr & connection, const std::string & errorMessage) override;
 	void onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message) override;
 
+	/// Switches proxy connection into relay mode once all its earlier messages have been processed
+	/// proxiesMutex must be locked by caller
+	void enableRelayIfReady(const NetworkConnectionPtr & connection);
+	void logRelayStatistics(const NetworkConnectionPtr & connection, const NetworkConnectionPtr & otherConnection);
+
+	void processDisconnected(const NetworkConnectionPtr & connection);
+	/// Processes message on lobby thread. Json is parsed on network thread, raw message is kept for proxy connections
+	void processPacket(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message, JsonNode json);
+
 	void sendMessage(const NetworkConnectionPtr & target, const JsonNode & json);
 
+	/// Sends list update to all logged in accounts. Every message is serialized only once
+	/// Accounts that don't support incremental updates receive full list instead
+	void broadcastListUpdate(const JsonNode & update, const std::function<JsonNode()> & makeFullList);
+
 	void broadcastActiveAccounts();
 	void broadcastActiveGameRooms();
+	void broadcastActiveAccounts(const std::vector<LobbyAccount> & activeAccountsStats);
+	void broadcastActiveGameRooms(const std::vector<LobbyGameRoom> & activeGameRoomStats);
 
+	JsonNode prepareActiveAccounts();
 	JsonNode prepareActiveGameRooms();
 
 	/// Attempts to load json from incoming byte stream and validate it
@@ -75,6 +134,7 @@ class LobbyServer final : public INetworkServerListener
 	void sendFullChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName, const std::string & channelNameForClient);
 	void sendRecentChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName);
 	void sendChatHistory(const NetworkConnectionPtr & target, const std::string & channelType, const std::string & channelName, const std::vector<LobbyChatMessage> & history);
+	void sendMatchesHistory(const NetworkConnectionPtr & target, const std::vector<LobbyGameRoom> & matchesHistory);
 	void sendAccountJoinsRoom(const NetworkConnectionPtr & target, const std::string & accountID);
 	void sendJoinRoomSuccess(const NetworkConnectionPtr & target, const std::string & gameRoomID, bool proxyMode);
 	void sendInviteReceived(const NetworkConnectionPtr & target, const std::string & accountID, const std::string & gameRoomID);
@@ -88,6 +148,8 @@ class LobbyServer final : public INetworkServerListener
 
 	void receiveSendChatMessage(const NetworkConnectionPtr & connection, const JsonNode & json);
 	void receiveRequestChatHistory(const NetworkConnectionPtr & connection, const JsonNode & json);
+	void receiveRequestActiveLists(const NetworkConnectionPtr & connection, const JsonNode & json);
+	void receiveEnableIncrementalUpdates(const NetworkConnectionPtr & connection, const JsonNode & json);
 	void receiveActivateGameRoom(const NetworkConnectionPtr & connection, const JsonNode & json);
 	void receiveJoinGameRoom(const NetworkConnectionPtr & connection, const JsonNode & json);
 	void receiveLeaveGameRoom(const NetworkConnectionPtr & connection, const JsonNode & json);
@@ -100,5 +162,7 @@ public:
 	~LobbyServer();
 
 	void start(uint16_t port);
+
+	/// Runs network on all available hardware threads, returns once network is stopped
 	void run();
 };
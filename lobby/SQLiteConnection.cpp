@@ -165,7 +165,11 @@ SQLiteInstancePtr SQLiteInstance::open(const boost::filesystem::path & db_path,
 	int result = sqlite3_open_v2(db_path.c_str(), &connection, flags, nullptr);
 
 	if(result == SQLITE_OK)
+	{
+		// database is shared by lobby and query threads, wait for lock held by another connection instead of failing
+		sqlite3_busy_timeout(connection, 5000);
 		return SQLiteInstancePtr(new SQLiteInstance(connection));
+	}
 
 	sqlite3_close(connection);
 	handleSQLiteError(connection);
@@ -0,0 +1,383 @@
+/*
+ * LobbyLoadTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/CThreadHelper.h"
+#include "../../lib/json/JsonNode.h"
+#include "../../lib/logging/CBasicLogConfigurator.h"
+#include "../../lib/network/NetworkInterface.h"
+#include "../../lib/VCMIDirs.h"
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+class LobbyLoadTest;
+
+/// Simulated vcmiclient that registers new account, logs in and sends series of chat messages,
+/// measuring time until server echoes each message back
+class LoadTestClient final : public INetworkClientListener
+{
+	using Clock = std::chrono::steady_clock;
+
+	LobbyLoadTest & owner;
+
+	/// Set by network thread once connected, but may be closed by driver thread at any moment
+	std::mutex connectionMutex;
+	NetworkConnectionPtr connection;
+
+	std::string displayName;
+	std::string accountID;
+
+	int messagesSent = 0;
+	bool finished = false;
+	Clock::time_point connectionStarted;
+	Clock::time_point messageSent;
+
+	void sendMessage(const JsonNode & json);
+	void sendNextChatMessage();
+
+	void onConnectionFailed(const std::string & errorMessage) override;
+	void onConnectionEstablished(const NetworkConnectionPtr & connection) override;
+	void onDisconnected(const NetworkConnectionPtr & connection, const std::string & errorMessage) override;
+	void onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message) override;
+
+public:
+	LoadTestClient(LobbyLoadTest & owner, const std::string & displayName);
+
+	void start(INetworkHandler & handler, const std::string & host, uint16_t port);
+	void stop();
+};
+
+class LobbyLoadTest final : public INetworkTimerListener
+{
+	std::unique_ptr<INetworkHandler> networkHandler;
+	std::vector<std::unique_ptr<LoadTestClient>> clients;
+
+	std::mutex statisticsMutex;
+	std::vector<double> loginTimes; // in milliseconds
+	std::vector<double> roundTripTimes; // in milliseconds
+	std::atomic<int> clientsFinished = 0;
+	std::atomic<int> clientsFailed = 0;
+	std::atomic<bool> stopped = false;
+
+	void onClientDone();
+	void onTimer() override;
+
+	static void printStatistics(const std::string & name, std::vector<double> & values);
+
+public:
+	const int messagesPerClient;
+
+	LobbyLoadTest(int clientsCount, int messagesPerClient);
+
+	void onLoggedIn(double milliseconds);
+	void onRoundTrip(double milliseconds);
+	void onClientFinished();
+	void onClientFailed(const std::string & displayName, const std::string & reason);
+
+	void run(const std::string & host, uint16_t port, int threadsCount, std::chrono::seconds timeout);
+};
+
+LoadTestClient::LoadTestClient(LobbyLoadTest & owner, const std::string & displayName)
+	: owner(owner)
+	, displayName(displayName)
+{
+}
+
+void LoadTestClient::start(INetworkHandler & handler, const std::string & host, uint16_t port)
+{
+	connectionStarted = Clock::now();
+	handler.connectToRemote(*this, host, port);
+}
+
+void LoadTestClient::stop()
+{
+	NetworkConnectionPtr currentConnection;
+	{
+		std::lock_guard lock(connectionMutex);
+		currentConnection = connection;
+	}
+
+	if (currentConnection)
+		currentConnection->close();
+}
+
+void LoadTestClient::sendMessage(const JsonNode & json)
+{
+	NetworkConnectionPtr currentConnection;
+	{
+		std::lock_guard lock(connectionMutex);
+		currentConnection = connection;
+	}
+
+	currentConnection->sendPacket(json.toBytes());
+}
+
+void LoadTestClient::sendNextChatMessage()
+{
+	JsonNode toSend;
+	toSend["type"].String() = "sendChatMessage";
+	toSend["messageText"].String() = "load test message " + std::to_string(messagesSent);
+	toSend["channelType"].String() = "global";
+	toSend["channelName"].String() = "english";
+
+	messagesSent += 1;
+	messageSent = Clock::now();
+	sendMessage(toSend);
+}
+
+void LoadTestClient::onConnectionFailed(const std::string & errorMessage)
+{
+	finished = true;
+	owner.onClientFailed(displayName, "connection failed: " + errorMessage);
+}
+
+void LoadTestClient::onConnectionEstablished(const NetworkConnectionPtr & newConnection)
+{
+	newConnection->setAsyncWritesEnabled(true);
+	{
+		std::lock_guard lock(connectionMutex);
+		connection = newConnection;
+	}
+
+	JsonNode toSend;
+	toSend["type"].String() = "clientRegister";
+	toSend["displayName"].String() = displayName;
+	toSend["language"].String() = "english";
+	toSend["version"].String() = VCMI_VERSION_STRING;
+	sendMessage(toSend);
+}
+
+void LoadTestClient::onDisconnected(const NetworkConnectionPtr & connection, const std::string & errorMessage)
+{
+	if (finished)
+		return;
+
+	finished = true;
+	owner.onClientFailed(displayName, "disconnected: " + errorMessage);
+}
+
+void LoadTestClient::onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message)
+{
+	JsonNode json(message.data(), message.size(), "<lobby message>");
+	const std::string & messageType = json["type"].String();
+
+	if (messageType == "accountCreated")
+	{
+		accountID = json["accountID"].String();
+
+		JsonNode toSend;
+		toSend["type"].String() = "clientLogin";
+		toSend["accountID"].String() = accountID;
+		toSend["accountCookie"].String() = json["accountCookie"].String();
+		toSend["language"].String() = "english";
+		toSend["version"].String() = VCMI_VERSION_STRING;
+		sendMessage(toSend);
+		return;
+	}
+
+	if (messageType == "clientLoginSuccess")
+	{
+		if (json["incrementalUpdates"].Bool())
+		{
+			JsonNode toSend;
+			toSend["type"].String() = "enableIncrementalUpdates";
+			sendMessage(toSend);
+		}
+
+		owner.onLoggedIn(std::chrono::duration<double, std::milli>(Clock::now() - connectionStarted).count());
+
+		if (owner.messagesPerClient > 0)
+			sendNextChatMessage();
+		else
+		{
+			finished = true;
+			owner.onClientFinished();
+		}
+		return;
+	}
+
+	if (messageType == "chatMessage" && json["accountID"].String() == accountID)
+	{
+		owner.onRoundTrip(std::chrono::duration<double, std::milli>(Clock::now() - messageSent).count());
+
+		if (messagesSent < owner.messagesPerClient)
+			sendNextChatMessage();
+		else
+		{
+			finished = true;
+			owner.onClientFinished();
+		}
+		return;
+	}
+
+	if (messageType == "operationFailed" && !finished)
+	{
+		finished = true;
+		owner.onClientFailed(displayName, json["reason"].String());
+	}
+}
+
+LobbyLoadTest::LobbyLoadTest(int clientsCount, int messagesPerClient)
+	: networkHandler(INetworkHandler::createHandler())
+	, messagesPerClient(messagesPerClient)
+{
+	// account names must be unique across runs against the same database
+	std::string runID = std::to_string(std::random_device()() % 1000000);
+
+	for (int i = 0; i < clientsCount; ++i)
+		clients.push_back(std::make_unique<LoadTestClient>(*this, "load" + runID + "x" + std::to_string(i)));
+}
+
+void LobbyLoadTest::onLoggedIn(double milliseconds)
+{
+	std::lock_guard lock(statisticsMutex);
+	loginTimes.push_back(milliseconds);
+}
+
+void LobbyLoadTest::onRoundTrip(double milliseconds)
+{
+	std::lock_guard lock(statisticsMutex);
+	roundTripTimes.push_back(milliseconds);
+}
+
+void LobbyLoadTest::onClientFinished()
+{
+	clientsFinished += 1;
+	onClientDone();
+}
+
+void LobbyLoadTest::onClientFailed(const std::string & displayName, const std::string & reason)
+{
+	// connections closed on shutdown are counted as timed out
+	if (stopped)
+		return;
+
+	logGlobal->warn("%s: %s", displayName, reason);
+	clientsFailed += 1;
+	onClientDone();
+}
+
+void LobbyLoadTest::onClientDone()
+{
+	if (clientsFinished + clientsFailed >= static_cast<int>(clients.size()))
+		onTimer();
+}
+
+void LobbyLoadTest::onTimer()
+{
+	if (stopped.exchange(true))
+		return;
+
+	for (auto & client : clients)
+		client->stop();
+
+	networkHandler->stop();
+}
+
+void LobbyLoadTest::printStatistics(const std::string & name, std::vector<double> & values)
+{
+	if (values.empty())
+	{
+		logGlobal->info("%s: no samples", name);
+		return;
+	}
+
+	std::sort(values.begin(), values.end());
+	double total = std::accumulate(values.begin(), values.end(), 0.0);
+
+	auto percentile = [&values](double fraction)
+	{
+		return values[std::min(values.size() - 1, static_cast<size_t>(values.size() * fraction))];
+	};
+
+	logGlobal->info("%s: %d samples, min %.2f ms, avg %.2f ms, median %.2f ms, p99 %.2f ms, max %.2f ms",
+		name, values.size(), values.front(), total / values.size(), percentile(0.5), percentile(0.99), values.back());
+}
+
+void LobbyLoadTest::run(const std::string & host, uint16_t port, int threadsCount, std::chrono::seconds timeout)
+{
+	logGlobal->info("Connecting %d clients to %s:%d, %d messages per client, %d threads", clients.size(), host, port, messagesPerClient, threadsCount);
+
+	auto started = std::chrono::steady_clock::now();
+
+	for (auto & client : clients)
+		client->start(*networkHandler, host, port);
+
+	networkHandler->createTimer(*this, timeout);
+
+	std::vector<boost::thread> networkThreads;
+	for (int i = 1; i < threadsCount; ++i)
+	{
+		networkThreads.emplace_back([this, i]()
+		{
+			setThreadName("network_" + std::to_string(i));
+			networkHandler->run();
+		});
+	}
+
+	networkHandler->run();
+
+	for (auto & thread : networkThreads)
+		thread.join();
+
+	double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+	std::lock_guard lock(statisticsMutex);
+
+	logGlobal->info("Finished in %.2f s: %d clients completed, %d failed, %d timed out",
+		elapsedSeconds, clientsFinished.load(), clientsFailed.load(), clients.size() - clientsFinished - clientsFailed);
+	printStatistics("Login time", loginTimes);
+	printStatistics("Chat round trip", roundTripTimes);
+	logGlobal->info("Chat throughput: %.1f messages per second", roundTripTimes.size() / elapsedSeconds);
+}
+
+int main(int argc, const char * argv[])
+{
+	po::options_description opts("Allowed options");
+	opts.add_options()
+		("help,h", "display help and exit")
+		("host", po::value<std::string>()->default_value("127.0.0.1"), "address of lobby server")
+		("port", po::value<uint16_t>()->default_value(3031), "port of lobby server")
+		("clients", po::value<int>()->default_value(1000), "number of simulated clients")
+		("messages", po::value<int>()->default_value(10), "number of chat messages sent by each client")
+		("threads", po::value<int>()->default_value(std::max(1u, boost::thread::hardware_concurrency())), "number of network threads")
+		("timeout", po::value<int>()->default_value(120), "time limit of the test, in seconds");
+
+	po::variables_map options;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, opts), options);
+		po::notify(options);
+	}
+	catch(const po::error & e)
+	{
+		std::cerr << "Failure during parsing command-line options:\n" << e.what() << std::endl;
+		return 1;
+	}
+
+	if(options.count("help"))
+	{
+		std::cout << opts << std::endl;
+		return 0;
+	}
+
+#ifndef VCMI_IOS
+	console = new CConsoleHandler();
+#endif
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userLogsPath() / "VCMI_LobbyLoadTest_log.txt", console);
+	logConfig.configureDefault();
+
+	LobbyLoadTest test(options["clients"].as<int>(), options["messages"].as<int>());
+	test.run(options["host"].as<std::string>(), options["port"].as<uint16_t>(), options["threads"].as<int>(), std::chrono::seconds(options["timeout"].as<int>()));
+
+	return 0;
+}
@@ -11,6 +11,7 @@
 #include "CGameHandler.h"
 
 #include "CVCMIServer.h"
+#include "SaveGameWriter.h"
 #include "TurnTimerHandler.h"
 #include "ServerNetPackVisitors.h"
 #include "ServerSpellCastEnvironment.h"
@@ -66,6 +67,7 @@
 
 #include "../lib/modding/ModIncompatibility.h"
 
+#include "../lib/network/NetworkInterface.h"
 #include "../lib/networkPacks/StackLocation.h"
 
 #include "../lib/pathfinder/CPathfinder.h"
@@ -77,6 +79,7 @@
 #include "../lib/serializer/CSaveFile.h"
 #include "../lib/serializer/CLoadFile.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/serializer/ESerializationVersion.h"
 
 #include "../lib/spells/CSpellHandler.h"
 
@@ -457,6 +460,9 @@ void CGameHandler::handleReceivedPack(CPackForServer * pack)
 	}
 
 	bool result;
+
+	// all changes caused by single client request reach clients as single network message
+	beginPackBatch();
 	try
 	{
 		ApplyGhNetPackVisitor applier(*this);
@@ -467,6 +473,12 @@ void CGameHandler::handleReceivedPack(CPackForServer * pack)
 	{
 		result = false;
 	}
+	catch(...)
+	{
+		endPackBatch();
+		throw;
+	}
+	endPackBatch();
 
 	if(result)
 		logGlobal->trace("Message %s successfully applied!", typeid(*pack).name());
@@ -491,6 +503,7 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 	, complainInvalidSlot("Invalid slot accessed!")
 	, turnTimerHandler(std::make_unique<TurnTimerHandler>(*this))
 	, newTurnProcessor(std::make_unique<NewTurnProcessor>(this))
+	, saveWriter(std::make_unique<SaveGameWriter>())
 {
 	QID = 1;
 
@@ -499,6 +512,7 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 
 CGameHandler::~CGameHandler()
 {
+	logPackStatistics();
 	delete spellEnv;
 	delete gs;
 	gs = nullptr;
@@ -512,12 +526,10 @@ void CGameHandler::reinitScripting()
 #endif
 }
 
-void CGameHandler::init(StartInfo *si, Load::ProgressAccumulator & progressTracking)
+void CGameHandler::init(StartInfo *si, Load::ProgressAccumulator & progressTracking, int randomSeed)
 {
-	int requestedSeed = settings["server"]["seed"].Integer();
-	if (requestedSeed != 0)
-		randomNumberGenerator->setSeed(requestedSeed);
-	logGlobal->info("Using random seed: %d", randomNumberGenerator->nextInt());
+	randomNumberGenerator->setSeed(randomSeed);
+	logGlobal->info("Using random seed: %d", randomSeed);
 
 	CMapService mapService;
 	gs = new CGameState();
@@ -718,6 +730,7 @@ void CGameHandler::start(bool resume)
 void CGameHandler::tick(int millisecondsPassed)
 {
 	turnTimerHandler->update(millisecondsPassed);
+	processFinishedSaves();
 }
 
 void CGameHandler::giveSpells(const CGTownInstance *t, const CGHeroInstance *h)
@@ -1388,8 +1401,144 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient * pack)
 {
 	logNetwork->trace("\tSending to all clients: %s", typeid(*pack).name());
-	for (auto c : lobby->activeConnections)
-		c->sendPack(pack);
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t encodedBytes = 0;
+	uint64_t sentBytes = 0;
+
+	// pack is serialized only once for each distinct set of serialization settings, usually once for all clients
+	std::vector<std::pair<std::shared_ptr<CConnection>, std::shared_ptr<const std::vector<std::byte>>>> encodedPacks;
+	PreparedPacks preparedPacks;
+
+	for (const auto & c : lobby->activeConnections)
+	{
+		std::shared_ptr<const std::vector<std::byte>> encoded;
+
+		for (const auto & entry : encodedPacks)
+		{
+			if (entry.first->hasSameSerializationSettings(*c))
+			{
+				encoded = entry.second;
+				break;
+			}
+		}
+
+		if (!encoded)
+		{
+			encoded = c->encodePack(pack);
+			encodedPacks.emplace_back(c, encoded);
+			encodedBytes += encoded->size();
+		}
+
+		if (packBatchDepth > 0 && c->hasSerializationFeature(ESerializationVersion::NETWORK_PACK_BATCH))
+		{
+			auto it = boost::range::find_if(batchedPacks, [&c](const auto & entry){ return entry.first == c; });
+
+			if (it == batchedPacks.end())
+				it = batchedPacks.insert(batchedPacks.end(), {c, {}});
+
+			it->second.push_back(encoded);
+		}
+		else
+			sendEncodedPack(c, encoded, preparedPacks);
+
+		sentBytes += encoded->size();
+	}
+
+	auto encodingTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	boost::mutex::scoped_lock lock(packStatisticsMutex);
+	auto & statistics = packStatistics[typeid(*pack).name()];
+	statistics.count++;
+	statistics.encodedBytes += encodedBytes;
+	statistics.sentBytes += sentBytes;
+	statistics.encodingTime += encodingTime;
+}
+
+void CGameHandler::sendEncodedPack(const std::shared_ptr<CConnection> & connection, const EncodedPack & encoded, PreparedPacks & preparedPacks)
+{
+	auto key = std::make_pair(encoded, connection->getCompressionThreshold());
+	auto it = preparedPacks.find(key);
+
+	if (it == preparedPacks.end())
+		it = preparedPacks.emplace(key, connection->prepareEncodedPack(encoded)).first;
+
+	connection->sendPreparedPack(it->second);
+}
+
+void CGameHandler::beginPackBatch()
+{
+	packBatchDepth++;
+}
+
+void CGameHandler::endPackBatch()
+{
+	assert(packBatchDepth > 0);
+
+	if (--packBatchDepth > 0)
+		return;
+
+	flushPackBatch();
+}
+
+void CGameHandler::flushPackBatch()
+{
+	std::vector<std::pair<std::shared_ptr<CConnection>, std::vector<EncodedPack>>> packsToSend;
+	std::swap(packsToSend, batchedPacks);
+
+	// connections with same serialization settings usually receive identical batches that are encoded only once
+	std::vector<std::tuple<std::shared_ptr<CConnection>, const std::vector<EncodedPack> *, EncodedPack>> encodedBatches;
+	PreparedPacks preparedPacks;
+
+	for (const auto & [connection, packs] : packsToSend)
+	{
+		if (packs.size() == 1)
+		{
+			sendEncodedPack(connection, packs.front(), preparedPacks);
+			continue;
+		}
+
+		EncodedPack encoded;
+
+		for (const auto & [otherConnection, otherPacks, otherEncoded] : encodedBatches)
+		{
+			if (*otherPacks == packs && otherConnection->hasSameSerializationSettings(*connection))
+			{
+				encoded = otherEncoded;
+				break;
+			}
+		}
+
+		if (!encoded)
+		{
+			PackBatch batch;
+			batch.encodedPacks = packs;
+
+			for (const auto & pack : packs)
+				batch.packSizes.push_back(pack->size());
+
+			encoded = connection->encodePack(&batch);
+			encodedBatches.emplace_back(connection, &packs, encoded);
+		}
+
+		logNetwork->trace("\tSending batch of %d packs", packs.size());
+		sendEncodedPack(connection, encoded, preparedPacks);
+	}
+}
+
+void CGameHandler::logPackStatistics()
+{
+	boost::mutex::scoped_lock lock(packStatisticsMutex);
+
+	for (const auto & [name, statistics] : packStatistics)
+	{
+		logNetwork->debug("Pack %s: sent %d times, %d bytes encoded, %d bytes sent, %d us spent",
+			name,
+			statistics.count,
+			statistics.encodedBytes,
+			statistics.sentBytes,
+			statistics.encodingTime);
+	}
 }
 
 void CGameHandler::sendAndApply(CPackForClient * pack)
@@ -1481,22 +1630,46 @@ void CGameHandler::save(const std::string & filename)
 	logGlobal->info("Saving to %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
 	const auto savefname = stem.to_string() + ".vsgm1";
-	ResourcePath savePath(stem.to_string(), EResType::SAVEGAME);
-	CResourceHandler::get("local")->createResource(savefname);
+	const std::string savesMountPoint = "Saves/";
 
 	try
 	{
-		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(savePath));
-			saveCommonState(save);
-			logGlobal->info("Saving server state");
-			save << *this;
-		}
-		logGlobal->info("Game has been successfully saved!");
+		if(!boost::istarts_with(savefname, savesMountPoint))
+			throw std::runtime_error("Save must be located in " + savesMountPoint + " directory");
+
+		// save is registered in resource system only once it is written, so it does not appear in saves list before that
+		auto savePath = VCMIDirs::get().userSavePath() / savefname.substr(savesMountPoint.size());
+		boost::filesystem::create_directories(savePath.parent_path());
+
+		auto start = std::chrono::steady_clock::now();
+
+		auto save = std::make_unique<CSaveFile>(savePath);
+		saveCommonState(*save);
+		logGlobal->info("Saving server state");
+		save->beginSection();
+		*save << *this;
+
+		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		logGlobal->info("Game state has been serialized in %d ms, writing it to disk", duration.count());
+
+		// only disk write happens in background, game state is already captured and may change freely
+		saveWriter->write(std::move(save), savefname);
 	}
 	catch(std::exception &e)
 	{
 		logGlobal->error("Failed to save game: %s", e.what());
+		playerMessages->broadcastSystemMessage("Failed to save game: " + std::string(e.what()));
+	}
+}
+
+void CGameHandler::processFinishedSaves()
+{
+	for(const auto & result : saveWriter->takeFinishedSaves())
+	{
+		if(result.error.empty())
+			CResourceHandler::get("local")->createResource(result.resourceName, true);
+		else
+			playerMessages->broadcastSystemMessage("Failed to save game: " + result.error);
 	}
 }
 
@@ -1505,6 +1678,9 @@ bool CGameHandler::load(const std::string & filename)
 	logGlobal->info("Loading from %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
 
+	saveWriter->waitUntilWritten();
+	processFinishedSaves();
+
 	reinitScripting();
 
 	try
@@ -22,6 +22,7 @@ struct SideInBattle;
 class IMarket;
 class SpellCastEnvironment;
 class CConnection;
+struct NetworkMessage;
 class CCommanderInstance;
 class EVictoryLossCheckResult;
 class CRandomGenerator;
@@ -52,6 +53,7 @@ class TurnTimerHandler;
 class QueriesProcessor;
 class CObjectVisitQuery;
 class NewTurnProcessor;
+class SaveGameWriter;
 
 class CGameHandler : public IGameCallback, public Environment
 {
@@ -189,7 +191,7 @@ public:
 	void expGiven(const CGHeroInstance *hero); //triggers needed level-ups, handles also commander of this hero
 	//////////////////////////////////////////////////////////////////////////
 
-	void init(StartInfo *si, Load::ProgressAccumulator & progressTracking);
+	void init(StartInfo *si, Load::ProgressAccumulator & progressTracking, int randomSeed);
 	void handleClientDisconnection(std::shared_ptr<CConnection> c);
 	void handleReceivedPack(CPackForServer * pack);
 	bool hasPlayerAt(PlayerColor player, std::shared_ptr<CConnection> c) const;
@@ -224,6 +226,8 @@ public:
 	bool bulkSmartSplitStack(SlotID slotSrc, ObjectInstanceID srcOwner);
 	void save(const std::string &fname);
 	bool load(const std::string &fname);
+	/// Registers saves that were written in background and reports failed ones to players
+	void processFinishedSaves();
 
 	void onPlayerTurnStarted(PlayerColor which);
 	void onPlayerTurnEnded(PlayerColor which);
@@ -258,6 +262,14 @@ public:
 
 	void sendToAllClients(CPackForClient * pack);
 	void sendAndApply(CPackForClient * pack) override;
+
+	/// Packs sent to all clients until matching endPackBatch are delivered as single network message
+	/// Only delivery is delayed - packs are applied on server immediately
+	void beginPackBatch();
+	void endPackBatch();
+	/// Sends packs batched so far without ending the batch, f.e. before sending pack to single client
+	void flushPackBatch();
+
 	void sendAndApply(CGarrisonOperationPack * pack);
 	void sendAndApply(SetResources * pack);
 	void sendAndApply(NewStructures * pack);
@@ -295,6 +307,35 @@ public:
 
 	friend class CVCMIServer;
 private:
+	struct PackStatistics
+	{
+		uint64_t count = 0;
+		uint64_t encodedBytes = 0;
+		uint64_t sentBytes = 0;
+		uint64_t encodingTime = 0; //in microseconds
+	};
+
+	using EncodedPack = std::shared_ptr<const std::vector<std::byte>>;
+	/// Encoded packs prepared for sending, for each compression threshold used by connections
+	using PreparedPacks = std::map<std::pair<EncodedPack, uint32_t>, NetworkMessage>;
+
+	/// Sends encoded pack to connection, compressing it only once for all connections with same compression threshold
+	void sendEncodedPack(const std::shared_ptr<CConnection> & connection, const EncodedPack & encoded, PreparedPacks & preparedPacks);
+
+	/// Nesting level of pack batches, packs are not sent to clients while it is above zero
+	int packBatchDepth = 0;
+	/// Packs waiting to be sent for each connection, in order in which they were sent
+	std::vector<std::pair<std::shared_ptr<CConnection>, std::vector<EncodedPack>>> batchedPacks;
+
+	/// pack type name -> statistics of broadcasts of this type
+	std::map<std::string, PackStatistics> packStatistics;
+	boost::mutex packStatisticsMutex;
+
+	void logPackStatistics();
+
+	/// writes saves to disk in background, once game state has been serialized
+	std::unique_ptr<SaveGameWriter> saveWriter;
+
 	std::unique_ptr<events::EventBus> serverEventBus;
 #if SCRIPTING_ENABLED
 	std::shared_ptr<scripting::PoolImpl> serverScripts;
@@ -11,12 +11,16 @@
 #include "CVCMIServer.h"
 
 #include "CGameHandler.h"
+#include "GameReplayRecorder.h"
 #include "GlobalLobbyProcessor.h"
 #include "LobbyNetPackVisitors.h"
 #include "processors/PlayerMessageProcessor.h"
 
+#include "../lib/CConfigHandler.h"
 #include "../lib/CHeroHandler.h"
 #include "../lib/CPlayerState.h"
+#include "../lib/CRandomGenerator.h"
+#include "../lib/VCMIDirs.h"
 #include "../lib/campaign/CampaignState.h"
 #include "../lib/gameState/CGameState.h"
 #include "../lib/mapping/CMapDefines.h"
@@ -55,7 +59,10 @@ public:
 	void visitForServer(CPackForServer & serverPack) override
 	{
 		if (gh)
+		{
+			handler.recordReceivedPack(serverPack);
 			gh->handleReceivedPack(&serverPack);
+		}
 		else
 			logNetwork->error("Received pack for game server while in lobby!");
 	}
@@ -185,7 +192,11 @@ void CVCMIServer::onTimer()
 	auto msDelta = msPassedNow - msPassedBefore;
 
 	if (msDelta.count())
+	{
+		if (replayRecorder)
+			replayRecorder->recordTimerTick(msDelta.count());
 		gh->tick(msDelta.count());
+	}
 	networkHandler->createTimer(*this, serverUpdateInterval);
 }
 
@@ -209,6 +220,7 @@ void CVCMIServer::prepareToRestart()
 	for(auto activeConnection : activeConnections)
 		activeConnection->enterLobbyConnectionMode();
 
+	replayRecorder.reset();
 	gh = nullptr;
 }
 
@@ -239,6 +251,10 @@ bool CVCMIServer::prepareToStartGame()
 		}
 	});
 	
+	int randomSeed = settings["server"]["seed"].Integer();
+	if (randomSeed == 0)
+		randomSeed = CRandomGenerator().nextInt();
+
 	gh = std::make_shared<CGameHandler>(this);
 	switch(si->mode)
 	{
@@ -248,14 +264,14 @@ bool CVCMIServer::prepareToStartGame()
 		si->fileURI = mi->fileURI;
 		si->campState->setCurrentMap(campaignMap);
 		si->campState->setCurrentMapBonus(campaignBonus);
-		gh->init(si.get(), progressTracking);
+		gh->init(si.get(), progressTracking, randomSeed);
 		break;
 
 	case EStartMode::NEW_GAME:
 		logNetwork->info("Preparing to start new game");
 		si->startTimeIso8601 = vstd::getDateTimeISO8601Basic(std::time(nullptr));
 		si->fileURI = mi->fileURI;
-		gh->init(si.get(), progressTracking);
+		gh->init(si.get(), progressTracking, randomSeed);
 		break;
 
 	case EStartMode::LOAD_GAME:
@@ -275,7 +291,27 @@ bool CVCMIServer::prepareToStartGame()
 	
 	current.finish();
 	progressTrackingThread.join();
-	
+
+	if (settings["server"]["recordReplay"].Bool())
+	{
+		std::vector<int> connectionIDs;
+		for(const auto & activeConnection : activeConnections)
+			connectionIDs.push_back(activeConnection->connectionID);
+
+		auto replayPath = VCMIDirs::get().userDataPath() / "Replays";
+		boost::filesystem::create_directories(replayPath);
+		replayPath /= "Replay_" + vstd::getDateTimeISO8601Basic(std::time(nullptr)) + ".vrpl";
+
+		try
+		{
+			replayRecorder = std::make_unique<GameReplayRecorder>(replayPath, *this, connectionIDs, randomSeed, gh->gs);
+		}
+		catch(const std::exception & e)
+		{
+			logGlobal->error("Failed to start recording of replay: %s", e.what());
+		}
+	}
+
 	return true;
 }
 
@@ -310,6 +346,9 @@ void CVCMIServer::onDisconnected(const std::shared_ptr<INetworkConnection> & con
 
 	if(gh && getState() == EServerState::GAMEPLAY)
 	{
+		if (replayRecorder)
+			replayRecorder->recordDisconnection(c->connectionID);
+
 		gh->handleClientDisconnection(c);
 
 		auto lcd = std::make_unique<LobbyClientDisconnected>();
@@ -333,6 +372,12 @@ void CVCMIServer::handleReceivedPack(std::unique_ptr<CPackForLobby> pack)
 	}
 }
 
+void CVCMIServer::recordReceivedPack(const CPackForServer & pack)
+{
+	if (replayRecorder)
+		replayRecorder->recordPack(pack);
+}
+
 void CVCMIServer::announcePack(std::unique_ptr<CPackForLobby> pack)
 {
 	for(auto activeConnection : activeConnections)
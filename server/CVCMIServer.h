@@ -17,6 +17,7 @@ VCMI_LIB_NAMESPACE_BEGIN
 class CMapInfo;
 
 struct CPackForLobby;
+struct CPackForServer;
 
 class CConnection;
 struct StartInfo;
@@ -31,6 +32,7 @@ class CGameHandler;
 class CBaseForServerApply;
 class CBaseForGHApply;
 class GlobalLobbyProcessor;
+class GameReplayRecorder;
 
 enum class EServerState : ui8
 {
@@ -44,6 +46,8 @@ class CVCMIServer : public LobbyInfo, public INetworkServerListener, public INet
 	/// Network server instance that receives and processes incoming connections on active socket
 	std::unique_ptr<INetworkServer> networkServer;
 	std::unique_ptr<GlobalLobbyProcessor> lobbyProcessor;
+	/// Records replay of current game, if enabled in settings
+	std::unique_ptr<GameReplayRecorder> replayRecorder;
 
 	std::chrono::steady_clock::time_point gameplayStartTime;
 	std::chrono::steady_clock::time_point lastTimerUpdateTime;
@@ -103,6 +107,7 @@ public:
 	void announceMessage(const std::string & txt);
 
 	void handleReceivedPack(std::unique_ptr<CPackForLobby> pack);
+	void recordReceivedPack(const CPackForServer & pack);
 
 	void updateAndPropagateLobbyState();
 
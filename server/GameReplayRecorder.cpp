@@ -0,0 +1,209 @@
+/*
+ * GameReplayRecorder.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "GameReplayRecorder.h"
+
+#include "../lib/StartInfo.h"
+#include "../lib/campaign/CampaignState.h"
+#include "../lib/gameState/CGameState.h"
+#include "../lib/json/JsonNode.h"
+#include "../lib/mapping/CMapHeader.h"
+#include "../lib/mapping/CMapInfo.h"
+#include "../lib/networkPacks/NetPacksBase.h"
+#include "../lib/rmg/CMapGenOptions.h"
+#include "../lib/serializer/Connection.h"
+
+#include <zlib.h>
+
+GameReplayRecorder::GameReplayRecorder(const boost::filesystem::path & path, const LobbyState & state, const std::vector<int> & connectionIDs, int randomSeed, CGameState * gs)
+	: path(path)
+	, file(path.c_str(), std::ios::out | std::ios::binary)
+	, gs(gs)
+	, lastRecordedDay(gs->day)
+	, serializer(this)
+{
+	logGlobal->info("Recording replay to %s", path.string());
+
+	if(!file)
+		THROW_FORMAT("Error: cannot open to write %s!", path.string());
+
+	file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+	// magic identifier and version are written uncompressed, everything after them is stored in chunks
+	auto version = ESerializationVersion::CURRENT;
+	file.write(REPLAY_MAGIC.data(), REPLAY_MAGIC.size());
+	file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+
+	serializer & randomSeed;
+	serializer & connectionIDs;
+	serializer & state;
+	writeChunk();
+
+	// packs are serialized in the same way as over network - game objects are referenced by their IDs
+	addStdVecItems(gs);
+	smartVectorMembersSerialization = true;
+	sendStackInstanceByIds = true;
+}
+
+GameReplayRecorder::~GameReplayRecorder()
+{
+	serializer & EReplayEntry::END;
+	writeChunk();
+}
+
+int GameReplayRecorder::write(const std::byte * data, unsigned size)
+{
+	buffer.insert(buffer.end(), data, data + size);
+	return size;
+}
+
+void GameReplayRecorder::reportState(vstd::CLoggerBase * out)
+{
+	out->debug("GameReplayRecorder");
+	out->debug("\tRecording to %s, %d bytes not written yet", path.string(), buffer.size());
+}
+
+void GameReplayRecorder::writeChunk()
+{
+	if(buffer.empty())
+		return;
+
+	uLongf compressedSize = compressBound(buffer.size());
+	std::vector<std::byte> compressed(compressedSize);
+
+	int result = compress2(reinterpret_cast<Bytef *>(compressed.data()), &compressedSize, reinterpret_cast<const Bytef *>(buffer.data()), buffer.size(), Z_DEFAULT_COMPRESSION);
+	if(result != Z_OK)
+	{
+		logGlobal->error("Failed to compress replay %s", path.string());
+		buffer.clear();
+		return;
+	}
+
+	uint32_t sizes[2] = { static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(compressedSize) };
+	buffer.clear();
+
+	try
+	{
+		file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+		file.write(reinterpret_cast<const char *>(compressed.data()), compressedSize);
+		// replay of game that has crashed remains readable up to last written chunk
+		file.flush();
+	}
+	catch(const std::exception & e)
+	{
+		// failure to record replay must not affect the game itself
+		logGlobal->error("Failed to write replay: %s", e.what());
+	}
+
+	packsInChunk = 0;
+}
+
+void GameReplayRecorder::recordPack(const CPackForServer & pack)
+{
+	const CPack * packPtr = &pack;
+
+	// packs of previous turn are written once new turn starts
+	if(gs->day != lastRecordedDay || packsInChunk >= packsPerChunk)
+	{
+		lastRecordedDay = gs->day;
+		writeChunk();
+	}
+
+	serializer & EReplayEntry::PACK;
+	serializer & pack.c->connectionID;
+	serializer & packPtr;
+	packsInChunk += 1;
+
+	// packs are deleted after processing, and their addresses may be reused by following packs
+	serializer.savedPointers.clear();
+}
+
+void GameReplayRecorder::recordTimerTick(int millisecondsPassed)
+{
+	serializer & EReplayEntry::TIMER_TICK;
+	serializer & millisecondsPassed;
+}
+
+void GameReplayRecorder::recordDisconnection(int connectionID)
+{
+	serializer & EReplayEntry::DISCONNECTION;
+	serializer & connectionID;
+}
+
+GameReplayReader::GameReplayReader(const boost::filesystem::path & path)
+	: fName(path.string())
+	, file(path.c_str(), std::ios::in | std::ios::binary)
+	, serializer(this)
+{
+	if(!file)
+		THROW_FORMAT("Error: cannot open to read %s!", fName);
+
+	file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+	std::string magic = REPLAY_MAGIC;
+	file.read(magic.data(), magic.size());
+	if(magic != REPLAY_MAGIC)
+		THROW_FORMAT("Error: not a VCMI replay (%s)!", fName);
+
+	file.read(reinterpret_cast<char *>(&serializer.version), sizeof(serializer.version));
+	if(serializer.version != ESerializationVersion::CURRENT)
+		THROW_FORMAT("Error: replay %s was recorded by different version of VCMI!", fName);
+
+	serializer.loadingGamestate = true;
+}
+
+bool GameReplayReader::loadNextChunk()
+{
+	if(file.peek() == std::char_traits<char>::eof())
+		return false;
+
+	uint32_t sizes[2];
+	file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+
+	std::vector<std::byte> compressed(sizes[1]);
+	file.read(reinterpret_cast<char *>(compressed.data()), compressed.size());
+
+	uLongf uncompressedSize = sizes[0];
+	chunk.resize(sizes[0]);
+	chunkPosition = 0;
+
+	int result = uncompress(reinterpret_cast<Bytef *>(chunk.data()), &uncompressedSize, reinterpret_cast<const Bytef *>(compressed.data()), compressed.size());
+	if(result != Z_OK || uncompressedSize != sizes[0])
+		THROW_FORMAT("Error: failed to decompress chunk of %s!", fName);
+
+	return true;
+}
+
+int GameReplayReader::read(std::byte * data, unsigned size)
+{
+	unsigned copied = 0;
+	while(copied < size)
+	{
+		if(chunkPosition == chunk.size() && !loadNextChunk())
+			THROW_FORMAT("Error: unexpected end of file (%s)!", fName);
+
+		size_t toCopy = std::min<size_t>(size - copied, chunk.size() - chunkPosition);
+		std::copy_n(chunk.data() + chunkPosition, toCopy, data + copied);
+		copied += toCopy;
+		chunkPosition += toCopy;
+	}
+	return size;
+}
+
+bool GameReplayReader::finished()
+{
+	return chunkPosition == chunk.size() && !loadNextChunk();
+}
+
+void GameReplayReader::reportState(vstd::CLoggerBase * out)
+{
+	out->debug("GameReplayReader");
+	out->debug("\tReading %s, position %d of %d in current chunk", fName, chunkPosition, chunk.size());
+}
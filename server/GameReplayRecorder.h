@@ -0,0 +1,86 @@
+/*
+ * GameReplayRecorder.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../lib/serializer/BinaryDeserializer.h"
+#include "../lib/serializer/BinarySerializer.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+class CGameState;
+struct CPackForServer;
+struct LobbyState;
+VCMI_LIB_NAMESPACE_END
+
+const std::string REPLAY_MAGIC = "VCMIREPLAY";
+
+/// Type of entry in replay file. Each entry is followed by its data
+enum class EReplayEntry : uint8_t
+{
+	END, // end of replay, no data
+	PACK, // id of connection and pack received from this connection
+	TIMER_TICK, // milliseconds passed since previous tick
+	DISCONNECTION // id of connection that was lost
+};
+
+/// Records game in form that can be repeated on server without any clients:
+/// lobby state and random seed used to start the game, followed by every pack received from clients in order of processing
+/// Replay is written to disk during the game as sequence of independently compressed chunks
+class GameReplayRecorder final : public IBinaryWriter
+{
+	/// Number of packs after which recorded data is flushed to disk, in addition to flush at start of every turn
+	static constexpr int packsPerChunk = 256;
+
+	boost::filesystem::path path;
+	std::fstream file;
+	std::vector<std::byte> buffer;
+
+	const CGameState * gs;
+	int packsInChunk = 0;
+	uint32_t lastRecordedDay;
+
+	void writeChunk();
+
+public:
+	BinarySerializer serializer;
+
+	GameReplayRecorder(const boost::filesystem::path & path, const LobbyState & state, const std::vector<int> & connectionIDs, int randomSeed, CGameState * gs);
+
+	/// Writes end of replay and remaining data to disk
+	~GameReplayRecorder();
+
+	int write(const std::byte * data, unsigned size) override;
+	void reportState(vstd::CLoggerBase * out) override;
+
+	void recordPack(const CPackForServer & pack);
+	void recordTimerTick(int millisecondsPassed);
+	void recordDisconnection(int connectionID);
+};
+
+/// Reads replay written by GameReplayRecorder, decompressing chunks one by one
+class GameReplayReader final : public IBinaryReader
+{
+	std::string fName;
+	std::fstream file;
+	std::vector<std::byte> chunk;
+	size_t chunkPosition = 0;
+
+	bool loadNextChunk();
+
+public:
+	BinaryDeserializer serializer;
+
+	explicit GameReplayReader(const boost::filesystem::path & path); //throws!
+
+	int read(std::byte * data, unsigned size) override; //throws!
+	void reportState(vstd::CLoggerBase * out) override;
+
+	/// Returns true if all data has been read. Replay of game that was interrupted may end without END entry
+	bool finished();
+};
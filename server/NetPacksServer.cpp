@@ -32,7 +32,7 @@
 void ApplyGhNetPackVisitor::visitSaveGame(SaveGame & pack)
 {
 	gh.save(pack.fname);
-	logGlobal->info("Game has been saved as %s", pack.fname);
+	logGlobal->info("Game is being saved as %s", pack.fname);
 	result = true;
 }
 
@@ -0,0 +1,100 @@
+/*
+ * SaveGameWriter.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "SaveGameWriter.h"
+
+#include "../lib/CThreadHelper.h"
+#include "../lib/serializer/CSaveFile.h"
+
+SaveGameWriter::SaveGameWriter()
+	: thread([this](){ threadLoop(); })
+{
+}
+
+SaveGameWriter::~SaveGameWriter()
+{
+	{
+		boost::unique_lock lock(mutex);
+		terminating = true;
+	}
+	condition.notify_all();
+	thread.join();
+}
+
+void SaveGameWriter::write(std::unique_ptr<CSaveFile> save, const std::string & resourceName)
+{
+	boost::unique_lock lock(mutex);
+
+	if (pendingSave && pendingSave->fName == save->fName)
+		logGlobal->info("Save to %s is superseded by newer one before being written", save->fName.string());
+	else
+		condition.wait(lock, [this](){ return pendingSave == nullptr; });
+
+	pendingSave = std::move(save);
+	pendingResourceName = resourceName;
+	condition.notify_all();
+}
+
+void SaveGameWriter::waitUntilWritten()
+{
+	boost::unique_lock lock(mutex);
+	condition.wait(lock, [this](){ return pendingSave == nullptr && !writeInProgress; });
+}
+
+std::vector<SaveGameWriter::WriteResult> SaveGameWriter::takeFinishedSaves()
+{
+	std::vector<WriteResult> result;
+
+	boost::unique_lock lock(mutex);
+	std::swap(result, finishedSaves);
+	return result;
+}
+
+void SaveGameWriter::threadLoop()
+{
+	setThreadName("saveGameWriter");
+
+	boost::unique_lock lock(mutex);
+
+	while (true)
+	{
+		// remaining saves are still written on shutdown
+		condition.wait(lock, [this](){ return pendingSave != nullptr || terminating; });
+
+		if (!pendingSave)
+			return;
+
+		std::unique_ptr<CSaveFile> save = std::move(pendingSave);
+		WriteResult result{std::move(pendingResourceName), {}};
+		writeInProgress = true;
+		condition.notify_all();
+
+		lock.unlock();
+
+		auto start = std::chrono::steady_clock::now();
+		try
+		{
+			save->writeToDisk();
+			auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+			logGlobal->info("Game has been successfully saved to %s! Written %d bytes in %d ms", save->fName.string(), save->buffer.size(), duration.count());
+		}
+		catch(const std::exception & e)
+		{
+			logGlobal->error("Failed to save game: %s", e.what());
+			result.error = e.what();
+		}
+		save.reset();
+
+		lock.lock();
+		finishedSaves.push_back(std::move(result));
+		writeInProgress = false;
+		condition.notify_all();
+	}
+}
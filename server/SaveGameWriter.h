@@ -0,0 +1,57 @@
+/*
+ * SaveGameWriter.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+VCMI_LIB_NAMESPACE_BEGIN
+class CSaveFile;
+VCMI_LIB_NAMESPACE_END
+
+/// Writes already serialized saves to disk on a background thread,
+/// so game is only paused for the time needed to serialize its state into memory
+class SaveGameWriter : boost::noncopyable
+{
+public:
+	struct WriteResult
+	{
+		/// name of save in resource system, as passed to write()
+		std::string resourceName;
+		/// description of error, empty if save was written successfully
+		std::string error;
+	};
+
+private:
+	boost::mutex mutex;
+	boost::condition_variable condition;
+
+	/// save that is waiting to be written. At most one save may wait, to keep memory usage bounded
+	std::unique_ptr<CSaveFile> pendingSave;
+	std::string pendingResourceName;
+	std::vector<WriteResult> finishedSaves;
+	bool writeInProgress = false;
+	bool terminating = false;
+
+	boost::thread thread;
+
+	void threadLoop();
+
+public:
+	SaveGameWriter();
+	~SaveGameWriter();
+
+	/// Queues save for writing. Replaces older save to the same file that is still waiting
+	/// Otherwise blocks until previously queued save has been taken for writing
+	void write(std::unique_ptr<CSaveFile> save, const std::string & resourceName);
+
+	/// Blocks until all queued saves have been written
+	void waitUntilWritten();
+
+	/// Returns saves that were written or failed since previous call
+	std::vector<WriteResult> takeFinishedSaves();
+};
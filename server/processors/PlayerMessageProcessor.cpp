@@ -114,7 +114,7 @@ void PlayerMessageProcessor::commandSave(PlayerColor player, const std::vector<s
 	if(words.size() == 2)
 	{
 		gameHandler->save("Saves/" + words[1]);
-		broadcastSystemMessage("game saved as " + words[1]);
+		broadcastSystemMessage("game is being saved as " + words[1]);
 	}
 }
 
@@ -831,6 +831,8 @@ void PlayerMessageProcessor::sendSystemMessage(std::shared_ptr<CConnection> conn
 {
 	SystemMessage sm;
 	sm.text = message;
+	// message must not overtake packs that were broadcast before it
+	gameHandler->flushPackBatch();
 	connection->sendPack(&sm);
 }
 
@@ -0,0 +1,298 @@
+/*
+ * ServerReplay.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../server/CGameHandler.h"
+#include "../../server/CVCMIServer.h"
+#include "../../server/GameReplayRecorder.h"
+
+#include "../../lib/CConsoleHandler.h"
+#include "../../lib/VCMIDirs.h"
+#include "../../lib/VCMI_Lib.h"
+#include "../../lib/campaign/CampaignState.h"
+#include "../../lib/gameState/CGameState.h"
+#include "../../lib/json/JsonNode.h"
+#include "../../lib/logging/CBasicLogConfigurator.h"
+#include "../../lib/mapping/CMapHeader.h"
+#include "../../lib/mapping/CMapInfo.h"
+#include "../../lib/network/NetworkInterface.h"
+#include "../../lib/networkPacks/NetPacksBase.h"
+#include "../../lib/rmg/CMapGenOptions.h"
+#include "../../lib/serializer/Connection.h"
+
+#include <boost/core/demangle.hpp>
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+/// Connection to client that does not exist. Everything that server sends to it is discarded
+class ReplayNetworkConnection final : public INetworkConnection
+{
+public:
+	void sendPacket(const std::vector<std::byte> & message) override {}
+	void sendPacket(const NetworkPacketPtr & message) override {}
+	NetworkMessage prepareMessage(const NetworkPacketPtr & message) const override { return {message, false}; }
+	void sendMessage(const NetworkMessage & message) override {}
+	uint32_t getCompressionThreshold() const override { return 0; }
+	void setAsyncWritesEnabled(bool on) override {}
+	void setCompressionThreshold(uint32_t threshold) override {}
+	void setRelayTarget(const std::shared_ptr<INetworkConnection> & target) override {}
+	NetworkRelayStatistics getRelayStatistics() const override { return {}; }
+	void close() override {}
+};
+
+struct ReplayTimings
+{
+	int count = 0;
+	double totalMilliseconds = 0;
+	double maxMilliseconds = 0;
+
+	void add(double milliseconds)
+	{
+		count += 1;
+		totalMilliseconds += milliseconds;
+		maxMilliseconds = std::max(maxMilliseconds, milliseconds);
+	}
+};
+
+/// Repeats recorded game on server as fast as possible, without clients, and measures time spent on processing of each pack
+class ServerReplay
+{
+	using Clock = std::chrono::steady_clock;
+
+	GameReplayReader file;
+	CVCMIServer server;
+
+	std::vector<NetworkConnectionPtr> networkConnections;
+	std::map<int, std::shared_ptr<CConnection>> connections;
+
+	std::map<std::string, ReplayTimings> packTimings;
+	std::map<int, ReplayTimings> dayTimings;
+
+	void startGame();
+	bool replayNextEntry();
+
+public:
+	explicit ServerReplay(const boost::filesystem::path & path);
+
+	void run();
+};
+
+ServerReplay::ServerReplay(const boost::filesystem::path & path)
+	: file(path)
+	, server(0, false)
+{
+}
+
+void ServerReplay::startGame()
+{
+	int randomSeed;
+	std::vector<int> connectionIDs;
+
+	file.serializer & randomSeed;
+	file.serializer & connectionIDs;
+	file.serializer & static_cast<LobbyState &>(server);
+
+	for(int connectionID : connectionIDs)
+	{
+		auto networkConnection = std::make_shared<ReplayNetworkConnection>();
+		auto connection = std::make_shared<CConnection>(networkConnection);
+		connection->connectionID = connectionID;
+
+		networkConnections.push_back(networkConnection);
+		connections[connectionID] = connection;
+		server.activeConnections.push_back(connection);
+	}
+
+	Load::ProgressAccumulator progressTracking;
+	server.gh = std::make_shared<CGameHandler>(&server);
+
+	if(server.si->mode == EStartMode::LOAD_GAME)
+	{
+		if(!server.gh->load(server.si->mapname))
+			THROW_FORMAT("Failed to load save %s used by replay!", server.si->mapname);
+	}
+	else
+		server.gh->init(server.si.get(), progressTracking, randomSeed);
+
+	server.startGameImmediately();
+
+	// packs were recorded in gameplay mode, with game objects referenced by their IDs
+	file.addStdVecItems(server.gh->gameState());
+	file.smartVectorMembersSerialization = true;
+	file.sendStackInstanceByIds = true;
+	file.serializer.cb = server.gh.get();
+}
+
+bool ServerReplay::replayNextEntry()
+{
+	if(file.finished())
+	{
+		logGlobal->warn("Replay ends without end marker, game was probably interrupted");
+		return false;
+	}
+
+	EReplayEntry entry;
+	file.serializer & entry;
+
+	int day = server.gh->gameState()->day;
+	std::string name;
+	Clock::time_point started;
+
+	switch(entry)
+	{
+		case EReplayEntry::END:
+			return false;
+
+		case EReplayEntry::PACK:
+		{
+			int connectionID;
+			CPack * pack = nullptr;
+
+			file.serializer & connectionID;
+			file.serializer & pack;
+			file.serializer.loadedPointers.clear();
+			file.serializer.loadedSharedPointers.clear();
+
+			auto * serverPack = dynamic_cast<CPackForServer *>(pack);
+			if(!serverPack)
+				throw std::runtime_error("Replay contains pack that is not for server!");
+
+			serverPack->c = connections.at(connectionID);
+			name = boost::core::demangle(typeid(*serverPack).name());
+
+			started = Clock::now();
+			server.gh->handleReceivedPack(serverPack);
+			break;
+		}
+
+		case EReplayEntry::TIMER_TICK:
+		{
+			int millisecondsPassed;
+			file.serializer & millisecondsPassed;
+			name = "timer tick";
+
+			started = Clock::now();
+			server.gh->tick(millisecondsPassed);
+			break;
+		}
+
+		case EReplayEntry::DISCONNECTION:
+		{
+			int connectionID;
+			file.serializer & connectionID;
+			name = "disconnection";
+
+			auto connection = connections.at(connectionID);
+			started = Clock::now();
+			vstd::erase(server.activeConnections, connection);
+			server.gh->handleClientDisconnection(connection);
+			break;
+		}
+
+		default:
+			throw std::runtime_error("Unknown entry in replay!");
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+	packTimings[name].add(milliseconds);
+	dayTimings[day].add(milliseconds);
+	return true;
+}
+
+void ServerReplay::run()
+{
+	auto started = Clock::now();
+	startGame();
+	double startSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+	while(replayNextEntry())
+	{
+	}
+
+	double totalSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+	std::vector<std::pair<std::string, ReplayTimings>> sortedTimings(packTimings.begin(), packTimings.end());
+	std::sort(sortedTimings.begin(), sortedTimings.end(), [](const auto & left, const auto & right)
+	{
+		return left.second.totalMilliseconds > right.second.totalMilliseconds;
+	});
+
+	logGlobal->info("Replay finished in %.2f s, game start took %.2f s", totalSeconds, startSeconds);
+
+	logGlobal->info("Time per pack type:");
+	for(const auto & [name, timings] : sortedTimings)
+		logGlobal->info("\t%s: %d packs, total %.2f ms, avg %.3f ms, max %.2f ms", name, timings.count, timings.totalMilliseconds, timings.totalMilliseconds / timings.count, timings.maxMilliseconds);
+
+	logGlobal->info("Time per turn:");
+	for(const auto & [day, timings] : dayTimings)
+		logGlobal->info("\tDay %d: %d packs, total %.2f ms, max %.2f ms", day, timings.count, timings.totalMilliseconds, timings.maxMilliseconds);
+}
+
+int main(int argc, const char * argv[])
+{
+	po::options_description opts("Allowed options");
+	opts.add_options()
+		("help,h", "display help and exit")
+		("replay", po::value<std::string>(), "path to replay file recorded by server");
+
+	po::positional_options_description positional;
+	positional.add("replay", 1);
+
+	po::variables_map options;
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(opts).positional(positional).run(), options);
+		po::notify(options);
+	}
+	catch(const po::error & e)
+	{
+		std::cerr << "Failure during parsing command-line options:\n" << e.what() << std::endl;
+		return 1;
+	}
+
+	if(options.count("help") || !options.count("replay"))
+	{
+		std::cout << "Usage: vcmireplay <replay file>\n" << opts << std::endl;
+		return 0;
+	}
+
+	auto replayPath = boost::filesystem::absolute(options["replay"].as<std::string>());
+
+	// Correct working dir executable folder (not bundle folder) so we can use executable relative paths
+	boost::filesystem::current_path(boost::filesystem::system_complete(argv[0]).parent_path());
+
+	console = new CConsoleHandler();
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userLogsPath() / "VCMI_Replay_log.txt", console);
+	logConfig.configureDefault();
+
+	preinitDLL(console, false);
+	logConfig.configure();
+	loadDLLClasses();
+
+	int result = 0;
+	try
+	{
+		ServerReplay replay(replayPath);
+		replay.run();
+
+		// server must be destroyed here - before VLC cleanup
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->error("Replay failed: %s", e.what());
+		result = 1;
+	}
+
+	logConfig.deconfigure();
+	vstd::clear_pointer(VLC);
+
+	return result;
+}
@@ -42,6 +42,9 @@ void CVcmiTestConfig::SetUp()
 		loader = new CFilesystemLoader("scripts/test/lua/", TEST_DATA_DIR+"lua/");
 		dynamic_cast<CFilesystemList*>(CResourceHandler::get("core"))->addLoader(loader, false);
 
+		loader = new CFilesystemLoader("config/schemas/test/", TEST_DATA_DIR+"schemas/");
+		dynamic_cast<CFilesystemList*>(CResourceHandler::get("core"))->addLoader(loader, false);
+
 	}
 }
 
@@ -0,0 +1,132 @@
+/*
+ * JsonParserTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/json/JsonFormatException.h"
+#include "../../lib/json/JsonNode.h"
+
+namespace test
+{
+
+class JsonParserTest : public ::testing::Test
+{
+public:
+	static JsonNode parse(const std::string & text, bool strict = false)
+	{
+		JsonParsingSettings settings;
+		settings.strict = strict;
+		return JsonNode(reinterpret_cast<const std::byte *>(text.data()), text.size(), settings, "<test>");
+	}
+
+	/// Parses string literal and returns its value
+	static std::string parseString(const std::string & literal, bool strict = true)
+	{
+		return parse("\"" + literal + "\"", strict).String();
+	}
+};
+
+TEST_F(JsonParserTest, duplicateKeyReplacesString)
+{
+	JsonNode node = parse("{ \"a\" : \"x\", \"a\" : \"y\" }");
+	EXPECT_EQ(node["a"].String(), "y");
+
+	node = parse("{ \"a\" : \"long value of first key\", \"a\" : \"short\" }");
+	EXPECT_EQ(node["a"].String(), "short");
+}
+
+TEST_F(JsonParserTest, duplicateKeyReplacesValueOfOtherType)
+{
+	JsonNode node = parse("{ \"a\" : \"x\", \"a\" : 5 }");
+	EXPECT_EQ(node["a"].Integer(), 5);
+
+	node = parse("{ \"a\" : 5, \"a\" : \"x\" }");
+	EXPECT_EQ(node["a"].String(), "x");
+}
+
+TEST_F(JsonParserTest, duplicateKeyIsWarning)
+{
+	EXPECT_THROW(parse("{ \"a\" : \"x\", \"a\" : \"y\" }", true), JsonFormatException);
+}
+
+TEST_F(JsonParserTest, stringsOfAnyLength)
+{
+	// cover strings shorter than, equal to and longer than one block of 8 characters checked at once
+	for(size_t length = 0; length < 40; ++length)
+	{
+		std::string text;
+		for(size_t i = 0; i < length; ++i)
+			text += static_cast<char>('a' + i % 26);
+
+		EXPECT_EQ(parseString(text), text) << "length " << length;
+	}
+}
+
+TEST_F(JsonParserTest, escapes)
+{
+	EXPECT_EQ(parseString("\\\""), "\"");
+	EXPECT_EQ(parseString("\\\\"), "\\");
+	EXPECT_EQ(parseString("\\/"), "/");
+	EXPECT_EQ(parseString("\\b\\f\\n\\r\\t"), "\b\f\n\r\t");
+	EXPECT_EQ(parseString("a\\\"b\\\\c"), "a\"b\\c");
+	EXPECT_THROW(parseString("\\q"), JsonFormatException);
+}
+
+TEST_F(JsonParserTest, escapeAtAnyPosition)
+{
+	// escape sequence placed inside of, and on boundary of, every block of 8 characters
+	for(size_t length = 0; length < 24; ++length)
+	{
+		for(size_t position = 0; position <= length; ++position)
+		{
+			std::string prefix(position, 'x');
+			std::string suffix(length - position, 'y');
+
+			EXPECT_EQ(parseString(prefix + "\\n" + suffix), prefix + "\n" + suffix) << "length " << length << ", position " << position;
+			EXPECT_EQ(parseString(prefix + "\\\"" + suffix), prefix + "\"" + suffix) << "length " << length << ", position " << position;
+		}
+	}
+}
+
+TEST_F(JsonParserTest, terminatorAtAnyPosition)
+{
+	for(size_t length = 0; length < 24; ++length)
+	{
+		std::string text(length, 'x');
+		JsonNode node = parse("[ \"" + text + "\", \"" + text + "\" ]", true);
+
+		ASSERT_EQ(node.Vector().size(), 2);
+		EXPECT_EQ(node.Vector()[0].String(), text);
+		EXPECT_EQ(node.Vector()[1].String(), text);
+	}
+}
+
+TEST_F(JsonParserTest, singleQuotedString)
+{
+	// double quotes inside of single-quoted string must not end the string
+	JsonNode node = parse("[ 'text \"with\" quotes' ]", true);
+	EXPECT_EQ(node.Vector().at(0).String(), "text \"with\" quotes");
+}
+
+TEST_F(JsonParserTest, invalidStrings)
+{
+	for(size_t position = 0; position < 16; ++position)
+	{
+		std::string prefix(position, 'x');
+
+		EXPECT_THROW(parseString(prefix + "\n" + "tail"), JsonFormatException) << "position " << position;
+		EXPECT_THROW(parseString(prefix + "\x01" + "tail"), JsonFormatException) << "position " << position;
+		EXPECT_THROW(parse("\"" + prefix, true), JsonFormatException) << "position " << position;
+	}
+
+	// control characters are skipped in non-strict mode
+	EXPECT_EQ(parseString(std::string("abcdefghij") + "\x01" + "klm", false), "abcdefghijklm");
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * JsonUtilsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/json/JsonUtils.h"
+
+namespace test
+{
+
+TEST(JsonUtilsTest, assembleFromValidFiles)
+{
+	bool isValid = false;
+	JsonNode result = JsonUtils::assembleFromFiles({"test/json/first", "test/json/second"}, isValid);
+
+	EXPECT_TRUE(isValid);
+	EXPECT_EQ(result["first"]["value"].Integer(), 1);
+	EXPECT_EQ(result["second"]["value"].Integer(), 2);
+}
+
+TEST(JsonUtilsTest, assembleWithBrokenFileIsInvalid)
+{
+	// single file with syntax errors makes whole set invalid, even if other files are fine
+	bool isValid = true;
+	JsonNode result = JsonUtils::assembleFromFiles({"test/json/first", "test/json/broken", "test/json/second"}, isValid);
+
+	EXPECT_FALSE(isValid);
+	EXPECT_EQ(result["first"]["value"].Integer(), 1);
+	EXPECT_EQ(result["second"]["value"].Integer(), 2);
+}
+
+TEST(JsonUtilsTest, assembleWithMissingFileIsInvalid)
+{
+	bool isValid = true;
+	JsonUtils::assembleFromFiles({"test/json/first", "test/json/missing"}, isValid);
+
+	EXPECT_FALSE(isValid);
+}
+
+}
@@ -0,0 +1,263 @@
+/*
+ * JsonValidatorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/filesystem/Filesystem.h"
+#include "../../lib/json/JsonUtils.h"
+#include "../../lib/json/JsonValidator.h"
+#include "../../lib/modding/ModScope.h"
+
+namespace test
+{
+
+/// Compares compiled validation (JsonValidator::isValid) with interpreted one (JsonValidator::check)
+/// Compiled schema may reject data that it can not validate on its own, but must never accept data that check() rejects
+class JsonValidatorTest : public ::testing::Test
+{
+public:
+	static constexpr auto keywordsSchema = "vcmi:test/keywords#/definitions/";
+
+	static JsonNode parse(const std::string & text)
+	{
+		JsonNode result(reinterpret_cast<const std::byte *>(text.data()), text.size(), "<test>");
+		// formats look up files in scope of validated node
+		result.setModScope(ModScope::scopeBuiltin());
+		return result;
+	}
+
+	static std::string resolveReference(const std::string & reference, const std::string & baseURI)
+	{
+		if(boost::algorithm::starts_with(reference, "#"))
+			return baseURI.substr(0, baseURI.find('#')) + reference;
+		return reference;
+	}
+
+	/// Returns true if schema or any schema referenced by it uses keywords that compiled schema does not implement
+	static bool usesFallbackKeywords(const JsonNode & schema, const std::string & baseURI, std::set<std::string> & visited)
+	{
+		static const std::set<std::string> fallbackKeywords = { "pattern", "patternProperties", "propertyNames", "contains", "examples" };
+
+		if(schema.isVector())
+			return std::any_of(schema.Vector().begin(), schema.Vector().end(), [&](const JsonNode & entry){ return usesFallbackKeywords(entry, baseURI, visited); });
+
+		if(!schema.isStruct())
+			return false;
+
+		for(const auto & entry : schema.Struct())
+		{
+			if(fallbackKeywords.count(entry.first))
+				return true;
+
+			if(entry.first == "$ref" && entry.second.isString())
+			{
+				std::string URI = resolveReference(entry.second.String(), baseURI);
+				if(visited.insert(URI).second && usesFallbackKeywords(JsonUtils::getSchema(URI), URI, visited))
+					return true;
+				continue;
+			}
+
+			if(usesFallbackKeywords(entry.second, baseURI, visited))
+				return true;
+		}
+		return false;
+	}
+
+	/// Generates data that is likely to pass schema, to have samples that are actually accepted by most schemas
+	static JsonNode makeSample(const JsonNode & schema, const std::string & baseURI, int depth)
+	{
+		if(depth > 8 || !schema.isStruct())
+			return JsonNode();
+
+		if(schema["$ref"].isString())
+		{
+			std::string URI = resolveReference(schema["$ref"].String(), baseURI);
+			return makeSample(JsonUtils::getSchema(URI), URI, depth + 1);
+		}
+
+		if(!schema["const"].isNull())
+			return schema["const"];
+		if(!schema["enum"].Vector().empty())
+			return schema["enum"].Vector().front();
+		if(!schema["default"].isNull())
+			return schema["default"];
+		if(!schema["anyOf"].Vector().empty())
+			return makeSample(schema["anyOf"].Vector().front(), baseURI, depth + 1);
+		if(!schema["oneOf"].Vector().empty())
+			return makeSample(schema["oneOf"].Vector().front(), baseURI, depth + 1);
+
+		JsonNode result;
+		const std::string & type = schema["type"].String();
+
+		if(type == "object")
+		{
+			result.Struct();
+			for(const auto & required : schema["required"].Vector())
+				result[required.String()] = makeSample(schema["properties"][required.String()], baseURI, depth + 1);
+		}
+		if(type == "array")
+			result.Vector();
+		if(type == "string")
+			result.String();
+		if(type == "number" || type == "integer")
+			result.Integer() = schema["minimum"].isNull() ? 0 : schema["minimum"].Integer();
+		if(type == "boolean")
+			result.Bool() = false;
+		return result;
+	}
+
+	static std::vector<JsonNode> makeSamples(const JsonNode & schema, const std::string & URI)
+	{
+		std::vector<JsonNode> result = {
+			parse("null"),
+			parse("true"),
+			parse("1"),
+			parse("1.5"),
+			parse("\"text\""),
+			parse("[]"),
+			parse("[ 1, \"text\" ]"),
+			parse("{}"),
+			parse("{ \"a\" : 1 }")
+		};
+
+		JsonNode sample = makeSample(schema, URI, 0);
+		result.push_back(sample);
+
+		if(sample.isStruct())
+		{
+			JsonNode extended = sample;
+			extended["unknownTestProperty"].Integer() = 1;
+			result.push_back(extended);
+
+			for(const auto & entry : sample.Struct())
+			{
+				JsonNode reduced = sample;
+				reduced.Struct().erase(entry.first);
+				result.push_back(reduced);
+			}
+		}
+
+		for(auto & entry : result)
+			entry.setModScope(ModScope::scopeBuiltin());
+		return result;
+	}
+
+	void expectResult(const std::string & definition, const std::string & data, bool expected)
+	{
+		std::string URI = keywordsSchema + definition;
+		JsonNode sample = parse(data);
+		JsonValidator validator;
+
+		EXPECT_EQ(validator.check(URI, sample).empty(), expected) << definition << ": " << data;
+		EXPECT_EQ(JsonValidator::isValid(URI, sample), expected) << definition << ": " << data;
+		EXPECT_EQ(JsonUtils::validate(sample, URI, definition), expected) << definition << ": " << data;
+	}
+};
+
+TEST_F(JsonValidatorTest, allSchemasAgree)
+{
+	auto schemaFiles = CResourceHandler::get()->getFilteredFiles([](const ResourcePath & path)
+	{
+		return path.getType() == EResType::JSON && boost::algorithm::starts_with(path.getName(), "CONFIG/SCHEMAS/");
+	});
+
+	ASSERT_FALSE(schemaFiles.empty());
+
+	size_t acceptedSamples = 0;
+	size_t rejectedSamples = 0;
+
+	for(const auto & file : schemaFiles)
+	{
+		std::string URI = "vcmi:" + boost::algorithm::to_lower_copy(file.getName().substr(std::string("CONFIG/SCHEMAS/").size()));
+		const JsonNode & schema = JsonUtils::getSchema(URI);
+
+		std::set<std::string> visited = { URI };
+		bool exact = !usesFallbackKeywords(schema, URI, visited);
+
+		for(const auto & sample : makeSamples(schema, URI))
+		{
+			JsonValidator validator;
+			bool interpreted = validator.check(URI, sample).empty();
+			bool compiled = JsonValidator::isValid(URI, sample);
+
+			if(compiled)
+			{
+				EXPECT_TRUE(interpreted) << URI << " accepts invalid data: " << sample.toCompactString();
+			}
+			if(exact)
+			{
+				EXPECT_EQ(compiled, interpreted) << URI << ": " << sample.toCompactString();
+			}
+
+			if(interpreted)
+				acceptedSamples++;
+			else
+				rejectedSamples++;
+		}
+	}
+
+	EXPECT_GT(acceptedSamples, 0);
+	EXPECT_GT(rejectedSamples, 0);
+}
+
+TEST_F(JsonValidatorTest, localReference)
+{
+	expectResult("localRef", "{ \"value\" : 5 }", true);
+	expectResult("localRef", "{ \"value\" : 0 }", false);
+	expectResult("localRef", "{ \"value\" : \"text\" }", false);
+}
+
+TEST_F(JsonValidatorTest, remoteReference)
+{
+	expectResult("remoteRef", "3", true);
+	expectResult("remoteRef", "-1", false);
+}
+
+TEST_F(JsonValidatorTest, recursiveReference)
+{
+	expectResult("tree", "{ \"name\" : \"a\", \"children\" : [ { \"name\" : \"b\", \"children\" : [ { \"name\" : \"c\" } ] } ] }", true);
+	expectResult("tree", "{ \"name\" : \"a\", \"children\" : [ { \"name\" : \"b\", \"children\" : [ { } ] } ] }", false);
+	expectResult("tree", "{ \"name\" : \"a\", \"children\" : [ { \"name\" : \"b\", \"extra\" : 1 } ] }", false);
+}
+
+TEST_F(JsonValidatorTest, additionalProperties)
+{
+	expectResult("closedObject", "{ \"a\" : 1 }", true);
+	expectResult("closedObject", "{ \"a\" : 1, \"b\" : 2 }", false);
+	expectResult("typedAdditionalProperties", "{ \"a\" : 1, \"b\" : \"text\" }", true);
+	expectResult("typedAdditionalProperties", "{ \"b\" : 2 }", false);
+}
+
+TEST_F(JsonValidatorTest, dependencies)
+{
+	expectResult("dependencies", "{}", true);
+	expectResult("dependencies", "{ \"a\" : 1, \"b\" : 2 }", true);
+	expectResult("dependencies", "{ \"a\" : 1 }", false);
+	expectResult("dependencies", "{ \"c\" : 1, \"d\" : 2 }", true);
+	expectResult("dependencies", "{ \"c\" : 1 }", false);
+}
+
+TEST_F(JsonValidatorTest, format)
+{
+	expectResult("format", "\"config/schemas/test/keywords\"", true);
+	expectResult("format", "\"config/schemas/test/noSuchFile\"", false);
+	expectResult("format", "5", false);
+	expectResult("unknownFormat", "\"text\"", false);
+}
+
+TEST_F(JsonValidatorTest, notImplementedKeywords)
+{
+	// check() reports such keywords as errors, compiled schema rejects everything it can not verify
+	expectResult("pattern", "\"aaa\"", false);
+	expectResult("patternProperties", "{ \"a\" : 1 }", false);
+	expectResult("propertyNames", "{ \"a\" : 1 }", false);
+	expectResult("contains", "[ 1 ]", false);
+}
+
+}
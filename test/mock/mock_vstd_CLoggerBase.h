@@ -39,5 +39,6 @@ public:
 
 	bool isDebugEnabled() const override {return true;}
 	bool isTraceEnabled() const override {return true;}
+	bool isEnabled(ELogLevel::ELogLevel level) const override {return true;}
 };
 
@@ -0,0 +1,161 @@
+/*
+ * FoWChangeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/networkPacks/PacksForClient.h"
+#include "../../lib/serializer/CMemorySerializer.h"
+
+namespace test
+{
+
+class FoWChangeTest : public ::testing::Test
+{
+public:
+	static constexpr int mapHeight = 36;
+
+	FoWChange subject;
+
+	FoWChangeTest()
+	{
+		subject.player = PlayerColor(2);
+		subject.mode = ETileVisibility::REVEALED;
+	}
+
+	std::unordered_set<int3> roundTrip()
+	{
+		CMemorySerializer mem;
+		mem.oser & subject;
+
+		FoWChange loaded;
+		mem.iser & loaded;
+
+		EXPECT_EQ(loaded.player, subject.player);
+		EXPECT_EQ(loaded.mode, subject.mode);
+		return loaded.getTiles();
+	}
+};
+
+TEST_F(FoWChangeTest, emptyChange)
+{
+	EXPECT_TRUE(FoWChange::makeSpans(subject.tiles).empty());
+	EXPECT_TRUE(roundTrip().empty());
+}
+
+TEST_F(FoWChangeTest, consecutiveTilesOfColumnFormSingleSpan)
+{
+	for(int y = 0; y < mapHeight; ++y)
+		subject.tiles.insert(int3(3, y, 0));
+
+	auto spans = FoWChange::makeSpans(subject.tiles);
+
+	ASSERT_EQ(spans.size(), 1);
+	EXPECT_EQ(spans[0].start, int3(3, 0, 0));
+	EXPECT_EQ(spans[0].length, mapHeight);
+	EXPECT_EQ(roundTrip(), subject.tiles);
+}
+
+TEST_F(FoWChangeTest, spanDoesNotContinueIntoNextColumn)
+{
+	// last tile of column x=3 is followed in memory by first tile of column x=4
+	subject.tiles.insert(int3(3, mapHeight - 2, 0));
+	subject.tiles.insert(int3(3, mapHeight - 1, 0));
+	subject.tiles.insert(int3(4, 0, 0));
+	subject.tiles.insert(int3(4, 1, 0));
+
+	auto spans = FoWChange::makeSpans(subject.tiles);
+
+	ASSERT_EQ(spans.size(), 2);
+	EXPECT_EQ(spans[0].start, int3(3, mapHeight - 2, 0));
+	EXPECT_EQ(spans[0].length, 2);
+	EXPECT_EQ(spans[1].start, int3(4, 0, 0));
+	EXPECT_EQ(spans[1].length, 2);
+	EXPECT_EQ(roundTrip(), subject.tiles);
+}
+
+TEST_F(FoWChangeTest, spanDoesNotContinueIntoOtherLevel)
+{
+	for(int y = 5; y < 10; ++y)
+	{
+		subject.tiles.insert(int3(7, y, 0));
+		subject.tiles.insert(int3(7, y, 1));
+	}
+
+	auto spans = FoWChange::makeSpans(subject.tiles);
+
+	ASSERT_EQ(spans.size(), 2);
+	EXPECT_EQ(spans[0].start, int3(7, 5, 0));
+	EXPECT_EQ(spans[0].length, 5);
+	EXPECT_EQ(spans[1].start, int3(7, 5, 1));
+	EXPECT_EQ(spans[1].length, 5);
+	EXPECT_EQ(roundTrip(), subject.tiles);
+}
+
+TEST_F(FoWChangeTest, gapsSplitSpans)
+{
+	subject.tiles.insert(int3(0, 0, 0));
+	subject.tiles.insert(int3(0, 2, 0));
+	subject.tiles.insert(int3(0, 3, 0));
+	subject.tiles.insert(int3(10, 20, 1));
+
+	auto spans = FoWChange::makeSpans(subject.tiles);
+
+	ASSERT_EQ(spans.size(), 3);
+	EXPECT_EQ(spans[0].length, 1);
+	EXPECT_EQ(spans[1].start, int3(0, 2, 0));
+	EXPECT_EQ(spans[1].length, 2);
+	EXPECT_EQ(spans[2].start, int3(10, 20, 1));
+	EXPECT_EQ(spans[2].length, 1);
+	EXPECT_EQ(roundTrip(), subject.tiles);
+}
+
+TEST_F(FoWChangeTest, loadedPackIsSavedAgain)
+{
+	subject.tiles.insert(int3(0, 0, 0));
+	subject.tiles.insert(int3(0, 1, 0));
+	subject.tiles.insert(int3(5, 7, 1));
+
+	CMemorySerializer first;
+	first.oser & subject;
+	FoWChange loaded;
+	first.iser & loaded;
+
+	CMemorySerializer second;
+	second.oser & loaded;
+	FoWChange reloaded;
+	second.iser & reloaded;
+
+	EXPECT_EQ(reloaded.getTiles(), subject.tiles);
+}
+
+TEST_F(FoWChangeTest, spansOutsideOfMapAreRejected)
+{
+	const int3 mapSize(mapHeight, mapHeight, 2);
+
+	auto checkTile = [&](const int3 & tile)
+	{
+		std::unordered_set<int3> tiles = { tile };
+		FoWChange::checkSpans(FoWChange::makeSpans(tiles), mapSize);
+	};
+
+	EXPECT_NO_THROW(checkTile(int3(mapHeight - 1, mapHeight - 1, 1)));
+	EXPECT_THROW(checkTile(int3(-1, 0, 0)), std::runtime_error);
+	EXPECT_THROW(checkTile(int3(mapHeight, 0, 0)), std::runtime_error);
+	EXPECT_THROW(checkTile(int3(0, mapHeight, 0)), std::runtime_error);
+	EXPECT_THROW(checkTile(int3(0, 0, 2)), std::runtime_error);
+
+	std::unordered_set<int3> column;
+	for(int y = 1; y <= mapHeight; ++y)
+		column.insert(int3(0, y, 0));
+
+	// span starts inside of map but ends past its last row
+	EXPECT_THROW(FoWChange::checkSpans(FoWChange::makeSpans(column), mapSize), std::runtime_error);
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+ * CLoadFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/serializer/CLoadFile.h"
+#include "../../lib/serializer/CSaveFile.h"
+
+namespace test
+{
+
+class CLoadFileTest : public ::testing::Test
+{
+public:
+	boost::filesystem::path fileName;
+
+	CLoadFileTest()
+		: fileName(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-test-%%%%-%%%%.vsgm1"))
+	{
+	}
+
+	~CLoadFileTest()
+	{
+		boost::system::error_code ec;
+		boost::filesystem::remove(fileName, ec);
+	}
+
+	static std::vector<std::byte> makeData(size_t size, int seed)
+	{
+		std::vector<std::byte> result(size);
+		for(size_t i = 0; i < size; ++i)
+			result[i] = static_cast<std::byte>((i * 7 + seed) % 251);
+		return result;
+	}
+
+	/// Returns offset of chunks table in saved file
+	size_t saveSections(const std::vector<std::vector<std::byte>> & sections)
+	{
+		CSaveFile saver(fileName);
+		for(size_t i = 0; i < sections.size(); ++i)
+		{
+			if(i != 0)
+				saver.beginSection();
+			saver.write(sections[i].data(), sections[i].size());
+		}
+		saver.writeToDisk();
+		return saver.sectionStarts.front();
+	}
+
+	void patchFile(size_t offset, uint32_t value)
+	{
+		std::fstream file(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(offset);
+		file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+};
+
+TEST_F(CLoadFileTest, severalSections)
+{
+	std::vector<std::vector<std::byte>> sections = {
+		makeData(100, 1),
+		makeData(CSaveFile::maxChunkSize * 2 + 100, 2), // split into 3 chunks
+		makeData(10, 3)
+	};
+
+	saveSections(sections);
+
+	CLoadFile loader(fileName);
+	for(const auto & section : sections)
+	{
+		std::vector<std::byte> loaded(section.size());
+		loader.read(loaded.data(), loaded.size());
+		EXPECT_EQ(loaded, section);
+	}
+
+	std::byte extra;
+	EXPECT_THROW(loader.read(&extra, 1), std::runtime_error);
+}
+
+TEST_F(CLoadFileTest, readAcrossSectionBoundary)
+{
+	std::vector<std::vector<std::byte>> sections = {
+		makeData(100, 1),
+		makeData(CSaveFile::maxChunkSize + 100, 2)
+	};
+
+	saveSections(sections);
+
+	std::vector<std::byte> expected;
+	for(const auto & section : sections)
+		expected.insert(expected.end(), section.begin(), section.end());
+
+	// single read that starts in header chunk and ends in second chunk of next section
+	CLoadFile loader(fileName);
+	std::vector<std::byte> loaded(expected.size());
+	loader.read(loaded.data(), loaded.size());
+	EXPECT_EQ(loaded, expected);
+}
+
+TEST_F(CLoadFileTest, readHeaderOnly)
+{
+	std::vector<std::vector<std::byte>> sections = {
+		makeData(100, 1),
+		makeData(1000, 2)
+	};
+
+	saveSections(sections);
+
+	CLoadFile loader(fileName);
+	std::vector<std::byte> loaded(sections[0].size());
+	loader.read(loaded.data(), loaded.size());
+	EXPECT_EQ(loaded, sections[0]);
+}
+
+TEST_F(CLoadFileTest, corruptedChunksCount)
+{
+	size_t tableOffset = saveSections({ makeData(100, 1) });
+	patchFile(tableOffset, std::numeric_limits<uint32_t>::max());
+
+	EXPECT_THROW(CLoadFile loader(fileName), std::runtime_error);
+}
+
+TEST_F(CLoadFileTest, corruptedCompressedSize)
+{
+	size_t tableOffset = saveSections({ makeData(100, 1) });
+	// chunks count, then section, uncompressed and compressed size of first chunk
+	patchFile(tableOffset + 3 * sizeof(uint32_t), std::numeric_limits<uint32_t>::max());
+
+	EXPECT_THROW(CLoadFile loader(fileName), std::runtime_error);
+}
+
+}